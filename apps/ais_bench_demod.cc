@@ -0,0 +1,556 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * ais_bench_demod: packet error rate and throughput of the demodulator.
+ *
+ * Builds AIS frames (random 168-bit payloads, training sequence, flags,
+ * FCS, bit stuffing and NRZI), GMSK modulates them (BT 0.4) at 96k
+ * samples per second with a random carrier phase per burst, a carrier
+ * offset and white noise, and gaps of noise between bursts. That goes
+ * through ais_rx's channel filter down to the chosen samples per symbol,
+ * then, timed, one of the demodulator chains of ais_demod and the
+ * deframer. Reports the fraction of frames not recovered intact, how
+ * often the preamble correlator fired, and the time taken against real
+ * time. The carrier offset is taken out by square_and_fft_sync_cc ahead
+ * of the demodulator, or with --freq-sync preamble per burst from the
+ * correlator's estimate, as ais_demod's freq_sync option. With
+ * --burst-agc the blocks chain has no feedforward AGC; corr_est_cc
+ * detects against a CFAR threshold and scales each burst from its
+ * correlation peak, as ais_demod's burst_agc option. --detector viterbi
+ * puts gmsk_viterbi_cb after the blocks chain's timing loop in place of
+ * the discriminator and slicer, as ais_demod's detector option, and
+ * reports how many bursts it was reset for.
+ *
+ * The sc16 and cs16 chains measure the int16 blocks against float ones
+ * on the same samples: the filtered signal is written to a temporary
+ * cs16 file at a fixed level, and read back through iq_file_source as
+ * int16 (corr_est_sc16, msk_timing_recovery_sc16) or as float
+ * (corr_est_cc, msk_timing_recovery_cc). Neither has an AGC or frequency
+ * sync, as ais_decode_file --sc16, so the timing loop's gain is set for
+ * that level rather than ais_demod's.
+ */
+
+#include <gnuradio/top_block.h>
+#include <gnuradio/block.h>
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/blocks/vector_source.h>
+#include <gnuradio/blocks/vector_sink.h>
+#include <gnuradio/blocks/unpacked_to_packed.h>
+#include <gnuradio/analog/feedforward_agc_cc.h>
+#include <gnuradio/analog/quadrature_demod_cf.h>
+#include <gnuradio/digital/binary_slicer_fb.h>
+#include <gnuradio/digital/diff_decoder_bb.h>
+#include <gnuradio/filter/firdes.h>
+#include <gnuradio/filter/freq_xlating_fir_filter.h>
+#include <gnuradio/expj.h>
+#include <gnuradio/blocks/interleaved_short_to_complex.h>
+#include <ais/iq_file_source.h>
+#include <ais/square_and_fft_sync_cc.h>
+#include <ais/burst_derotator_cc.h>
+#include <ais/demod_cb.h>
+#include <ais/corr_est_cc.h>
+#include <ais/msk_timing_recovery_cc.h>
+#include <ais/invert.h>
+#include <ais/gmsk_viterbi_cb.h>
+#include <ais/hdlc_deframer_bp.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <getopt.h>
+#include <unistd.h>
+
+namespace {
+
+  const double bits_per_sec = 9600.0;
+  const int wide_sps = 10; // the "air" rate, 96k
+  const double bt = 0.4;
+  const double span = 2.0; // of the frequency pulse either side, in symbols
+  // The timing error detector's output grows as the fourth power of the
+  // amplitude; without an AGC the loop gain is this over amplitude^4,
+  // the best of those tried here at 2 and 5 sps. Keep in step with
+  // ais_decode_file.
+  const double gain_a4 = 1.0/16;
+
+  // Phase pulse: the frequency pulse integrated from its start to t
+  // symbols from its centre, scaled to end at 1
+  double
+  phase_pulse(double t)
+  {
+    const double k = 2*M_PI*bt/sqrt(log(2.0))/M_SQRT2;
+    const int steps = 256;
+    double total = 0, part = 0;
+    for(int i = 0; i < 2*span*steps; i++) {
+      double u = -span + (i + 0.5)/steps;
+      double g = erfc(k*(u - 0.5)) - erfc(k*(u + 0.5));
+      total += g;
+      if(u < t)
+        part += g;
+    }
+    return part/total;
+  }
+
+  uint16_t
+  crc16_x25(const std::vector<uint8_t> &p)
+  {
+    uint16_t crc = 0xFFFF;
+    for(size_t i = 0; i < p.size(); i++) {
+      crc ^= p[i];
+      for(int b = 0; b < 8; b++)
+        crc = (crc & 1) ? (crc >> 1) ^ 0x8408 : (crc >> 1);
+    }
+    return crc ^ 0xFFFF;
+  }
+
+  // Channel symbols (+/-1) of one transmission: ramp, training sequence,
+  // flag, stuffed payload and FCS, flag, NRZI coded (a zero is a change)
+  std::vector<int>
+  frame_symbols(const std::vector<uint8_t> &payload)
+  {
+    std::vector<int> bits(8, 0);
+    for(int i = 0; i < 24; i++)
+      bits.push_back(i & 1);
+    const int flag[8] = {0, 1, 1, 1, 1, 1, 1, 0};
+    bits.insert(bits.end(), flag, flag + 8);
+
+    std::vector<uint8_t> body(payload);
+    uint16_t fcs = crc16_x25(payload);
+    body.push_back(fcs & 0xFF);
+    body.push_back(fcs >> 8);
+    int ones = 0;
+    for(size_t i = 0; i < body.size(); i++)
+      for(int b = 0; b < 8; b++) { // first bit in the LSB
+        int bit = (body[i] >> b) & 1;
+        bits.push_back(bit);
+        ones = bit ? ones + 1 : 0;
+        if(ones == 5) {
+          bits.push_back(0);
+          ones = 0;
+        }
+      }
+    bits.insert(bits.end(), flag, flag + 8);
+    bits.insert(bits.end(), 8, 0);
+
+    std::vector<int> sym(bits.size());
+    int level = 1;
+    for(size_t i = 0; i < bits.size(); i++) {
+      if(!bits[i])
+        level = -level;
+      sym[i] = level;
+    }
+    return sym;
+  }
+
+  // GMSK at wide_sps, unit amplitude, added into x from sample start on
+  void
+  modulate(const std::vector<int> &sym, double phase, double freq,
+           std::vector<gr_complex> &x, size_t start)
+  {
+    // the phase pulse a whole number of samples either side of its centre
+    const int reach = (int) ceil(span) + 1;
+    std::vector<double> q(2*reach*wide_sps + 1);
+    for(size_t i = 0; i < q.size(); i++)
+      q[i] = phase_pulse((double) i/wide_sps - reach);
+
+    // symbol i is centred on sample (i + 0.5)*wide_sps
+    const int n = sym.size()*wide_sps;
+    const int nsym = sym.size();
+    double done = 0; // symbols whose pulse has passed
+    int passed = 0;
+    for(int s = 0; s < n; s++) {
+      double ph = done;
+      for(int i = passed; i < nsym; i++) {
+        int u = s - i*wide_sps - wide_sps/2 + reach*wide_sps;
+        if(u < 0)
+          break;
+        if(u >= (int) q.size() - 1) {
+          done += sym[i];
+          passed = i + 1;
+          ph += sym[i];
+        }
+        else
+          ph += sym[i]*q[u];
+      }
+      ph = M_PI/2*ph + phase + freq*(start + s);
+      x[start + s] += gr_expj(ph);
+    }
+  }
+
+  /*
+   * The preamble template ais_demod correlates against; see
+   * ais_decode_file.
+   */
+  std::vector<gr_complex>
+  preamble_symbols(int sps)
+  {
+    std::vector<float> bits;
+    float level = 1;
+    for(int i = 0; i < 32; i++) {
+      bool one = i < 24 ? (i & 1) : (i > 24 && i < 31); // training, flag
+      if(!one)
+        level = -level;
+      bits.push_back(level);
+    }
+
+    std::vector<float> gauss = gr::filter::firdes::gaussian(1, sps, 0.4, 4*sps);
+    std::vector<float> taps(gauss.size() + sps - 1, 0);
+    for(size_t i = 0; i < gauss.size(); i++)
+      for(int j = 0; j < sps; j++)
+        taps[i+j] += gauss[i];
+
+    size_t n = bits.size()*sps;
+    std::vector<gr_complex> out(n);
+    float sensitivity = (M_PI/2)/sps, phase = 0;
+    for(size_t i = 0; i < n; i++) {
+      float shaped = 0;
+      for(size_t k = 0; k <= i && k < taps.size(); k++)
+        if((i - k) % sps == 0)
+          shaped += taps[k]*bits[(i - k)/sps];
+      phase += sensitivity*shaped;
+      out[i] = gr_expj(phase);
+    }
+    return out;
+  }
+
+  /*
+   * Counts the deframer's frames that match one sent.
+   */
+  class frame_counter : public gr::block
+  {
+    const std::set<std::vector<uint8_t> > &d_sent;
+    std::set<std::vector<uint8_t> > d_seen;
+    int d_bad;
+
+  public:
+    typedef boost::shared_ptr<frame_counter> sptr;
+
+    frame_counter(const std::set<std::vector<uint8_t> > &sent)
+      : gr::block("frame_counter",
+                  gr::io_signature::make(0, 0, 0),
+                  gr::io_signature::make(0, 0, 0)),
+        d_sent(sent), d_bad(0)
+    {
+      message_port_register_in(pmt::mp("in"));
+      set_msg_handler(pmt::mp("in"), boost::bind(&frame_counter::handle, this, _1));
+    }
+
+    void handle(pmt::pmt_t msg)
+    {
+      pmt::pmt_t vec = pmt::cdr(msg);
+      size_t len = pmt::length(vec);
+      const uint8_t *data = pmt::u8vector_elements(vec, len);
+      std::vector<uint8_t> f(data, data + len);
+      if(d_sent.count(f))
+        d_seen.insert(f);
+      else
+        d_bad++;
+    }
+
+    int good() const { return d_seen.size(); }
+    int bad() const { return d_bad; }
+  };
+
+  void
+  usage(const char *prog)
+  {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "Time the AIS demodulator over synthetic bursts and count lost frames.\n"
+            "  -n, --frames <n>       bursts to send [default=500]\n"
+            "  -s, --snr <dB>         Eb/N0 [default=17]\n"
+            "  -f, --offset <Hz>      carrier offset [default=200]\n"
+            "  -p, --sps <n>          samples per symbol after the channel filter, 2 or 5 [default=5]\n"
+            "  -c, --chain <name>     fused (demod_cb), blocks (corr_est_cc and\n"
+            "                         msk_timing_recovery_cc), or sc16 or cs16 from a\n"
+            "                         cs16 file as int16 or float [default=fused]\n"
+            "  -L, --level <a>        signal amplitude in the cs16 file, of full scale [default=0.25]\n"
+            "  -t, --threshold <t>    correlator threshold, of the template's energy squared [default=0.9]\n"
+
+            "  -a, --acq-gain <g>     acquisition loop gain [default=0.15]\n"
+            "  -l, --acq-len <n>      acquisition length in symbols [default=0, off]\n"
+            "  -F, --freq-sync <how>  fft (square_and_fft_sync_cc) or preamble (per burst,\n"
+            "                         fused and blocks only) [default=fft]\n"
+            "  -A, --burst-agc        scale each burst from its preamble instead of the\n"
+            "                         sliding AGC (blocks only)\n"
+            "  -d, --detector <name>  discriminator or viterbi (gmsk_viterbi_cb, blocks\n"
+            "                         only) [default=discriminator]\n"
+            "  -x, --no-sync          leave out frequency correction\n",
+            prog);
+  }
+
+} // anonymous namespace
+
+int
+main(int argc, char **argv)
+{
+  int nframes = 500, sps = 5, acq_len = 0;
+  double snr = 17, offset = 200, acq_gain = 0.15, level = 0.25, threshold = 0.9;
+  std::string chain = "fused", freq_sync = "fft", detector = "discriminator";
+  bool sync = true, burst_agc = false;
+
+  static const struct option longopts[] = {
+    {"frames", required_argument, 0, 'n'},
+    {"snr", required_argument, 0, 's'},
+    {"offset", required_argument, 0, 'f'},
+    {"sps", required_argument, 0, 'p'},
+    {"chain", required_argument, 0, 'c'},
+    {"acq-gain", required_argument, 0, 'a'},
+    {"acq-len", required_argument, 0, 'l'},
+    {"level", required_argument, 0, 'L'},
+    {"threshold", required_argument, 0, 't'},
+    {"freq-sync", required_argument, 0, 'F'},
+    {"burst-agc", no_argument, 0, 'A'},
+    {"detector", required_argument, 0, 'd'},
+    {"no-sync", no_argument, 0, 'x'},
+    {"help", no_argument, 0, 'h'},
+    {0, 0, 0, 0}
+  };
+  int opt;
+  while((opt = getopt_long(argc, argv, "n:s:f:p:c:a:l:L:t:F:Ad:xh", longopts, 0)) != -1) {
+    switch(opt) {
+    case 'n': nframes = atoi(optarg); break;
+    case 's': snr = atof(optarg); break;
+    case 'f': offset = atof(optarg); break;
+    case 'p': sps = atoi(optarg); break;
+    case 'c': chain = optarg; break;
+    case 'a': acq_gain = atof(optarg); break;
+    case 'l': acq_len = atoi(optarg); break;
+    case 'L': level = atof(optarg); break;
+    case 't': threshold = atof(optarg); break;
+    case 'F': freq_sync = optarg; break;
+    case 'A': burst_agc = true; break;
+    case 'd': detector = optarg; break;
+    case 'x': sync = false; break;
+    default: usage(argv[0]); return opt == 'h' ? 0 : 1;
+    }
+  }
+  const bool file = chain == "sc16" || chain == "cs16";
+  if(optind != argc || nframes < 1 || (sps != 2 && sps != 5) || acq_len < 0
+     || (chain != "fused" && chain != "blocks" && !file)
+     || (freq_sync != "fft" && freq_sync != "preamble")
+     || (freq_sync == "preamble" && file)
+     || (burst_agc && chain != "blocks")
+     || (detector != "discriminator" && detector != "viterbi")
+     || (detector == "viterbi" && chain != "blocks")
+     || level <= 0 || level >= 1) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  // The recording: a second of noise for the frequency sync to settle,
+  // then the bursts with 10 to 40 ms of noise between them
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> uniform(0, 1);
+  const double rate = bits_per_sec*wide_sps;
+  std::vector<std::vector<int> > bursts;
+  std::vector<size_t> starts;
+  std::set<std::vector<uint8_t> > sent;
+  size_t len = (size_t) rate;
+  for(int i = 0; i < nframes; i++) {
+    std::vector<uint8_t> payload(21);
+    for(size_t b = 0; b < payload.size(); b++)
+      payload[b] = rng() & 0xFF;
+    sent.insert(payload);
+    bursts.push_back(frame_symbols(payload));
+    starts.push_back(len);
+    len += bursts.back().size()*wide_sps + (size_t)((0.01 + 0.03*uniform(rng))*rate);
+  }
+  std::vector<gr_complex> x(len);
+  for(int i = 0; i < nframes; i++)
+    modulate(bursts[i], 2*M_PI*uniform(rng), 2*M_PI*offset/rate, x, starts[i]);
+  // unit signal power; Eb/N0 over the samples of a bit
+  std::normal_distribution<float> noise(0, sqrt(0.5*wide_sps/pow(10.0, snr/10)));
+  for(size_t i = 0; i < len; i++)
+    x[i] += gr_complex(noise(rng), noise(rng));
+
+  // ais_rx's channel filter, ahead of the timed part
+  int decim = wide_sps/sps;
+  double chan_rate = rate/decim;
+  double cutoff = std::min(11000.0, 0.42*chan_rate);
+  gr::top_block_sptr ftb = gr::make_top_block("ais_bench_demod_filter");
+  gr::blocks::vector_source<gr_complex>::sptr wide =
+    gr::blocks::vector_source<gr_complex>::make(x);
+  gr::filter::freq_xlating_fir_filter_ccf::sptr filter =
+    gr::filter::freq_xlating_fir_filter_ccf::make(decim,
+                                                  gr::filter::firdes::low_pass(1, rate, cutoff, 1000),
+                                                  0, rate);
+  gr::blocks::vector_sink<gr_complex>::sptr chan =
+    gr::blocks::vector_sink<gr_complex>::make(1, len/decim);
+  ftb->connect(wide, 0, filter, 0);
+  ftb->connect(filter, 0, chan, 0);
+  ftb->run();
+
+  gr::top_block_sptr tb = gr::make_top_block("ais_bench_demod");
+  gr::basic_block_sptr head;
+  char path[] = "/tmp/ais_bench_demod_XXXXXX";
+  const std::vector<gr_complex> filtered = chan->data();
+  if(file) {
+    std::vector<int16_t> iq(2*filtered.size());
+    for(size_t i = 0; i < filtered.size(); i++) {
+      gr_complex v = filtered[i]*(float)(level*32768);
+      iq[2*i] = (int16_t) std::max(-32768.0f, std::min(32767.0f, rintf(v.real())));
+      iq[2*i+1] = (int16_t) std::max(-32768.0f, std::min(32767.0f, rintf(v.imag())));
+    }
+    int fd = mkstemp(path);
+    if(fd < 0 || write(fd, &iq[0], iq.size()*sizeof(int16_t))
+       != (ssize_t)(iq.size()*sizeof(int16_t))) {
+      perror(path);
+      return 1;
+    }
+    close(fd);
+    head = gr::ais::iq_file_source::make(path, gr::ais::IQ_CS16, false, 0, 0,
+                                         chain == "sc16");
+  }
+  else {
+    head = gr::blocks::vector_source<gr_complex>::make(filtered);
+  }
+  const bool preamble_sync = sync && freq_sync == "preamble";
+  if(sync && !file && !preamble_sync) {
+    gr::ais::square_and_fft_sync_cc::sptr fsync =
+      gr::ais::square_and_fft_sync_cc::make(chan_rate, (int) bits_per_sec, 1024);
+    tb->connect(head, 0, fsync, 0);
+    head = fsync;
+  }
+
+  // as ais_demod
+  const double gain = gain_a4/pow(level, 4);
+  std::vector<gr_complex> preamble = preamble_symbols(sps);
+  const int agc_len = (int) lrint(512*sps/5.0);
+  gr::blocks::unpacked_to_packed_bb::sptr pack =
+    gr::blocks::unpacked_to_packed_bb::make(1, gr::GR_MSB_FIRST);
+  gr::ais::demod_cb::sptr demod;
+  gr::ais::corr_est_cc::sptr corr;
+  gr::ais::corr_est_sc16::sptr corr16;
+  gr::analog::quadrature_demod_cf::sptr disc = gr::analog::quadrature_demod_cf::make(M_PI/2);
+  gr::digital::binary_slicer_fb::sptr slicer = gr::digital::binary_slicer_fb::make();
+  gr::digital::diff_decoder_bb::sptr diff = gr::digital::diff_decoder_bb::make(2);
+  gr::ais::invert::sptr inv = gr::ais::invert::make();
+  gr::ais::gmsk_viterbi_cb::sptr viterbi;
+  if(chain == "fused") {
+    demod =
+      gr::ais::demod_cb::make(preamble, sps, 1, threshold, 0.04, 0.01, agc_len, 2);
+    if(acq_len > 0)
+      demod->set_acquisition(acq_gain, acq_len);
+    demod->set_freq_correction(preamble_sync);
+    tb->connect(head, 0, demod, 0);
+    tb->connect(demod, 0, pack, 0);
+  }
+  else if(chain == "blocks") {
+    if(burst_agc) {
+      corr = gr::ais::corr_est_cc::make(preamble, sps, 1, 1e-6,
+                                        gr::ais::THRESHOLD_CFAR);
+      corr->set_burst_agc(2, (int) ceil(1280*sps));
+      tb->connect(head, 0, corr, 0);
+    }
+    else {
+      gr::analog::feedforward_agc_cc::sptr agc =
+        gr::analog::feedforward_agc_cc::make(agc_len, 2);
+      corr = gr::ais::corr_est_cc::make(preamble, sps, 1, threshold);
+      tb->connect(head, 0, agc, 0);
+      tb->connect(agc, 0, corr, 0);
+    }
+    gr::ais::msk_timing_recovery_cc::sptr clockrec =
+      gr::ais::msk_timing_recovery_cc::make(sps, 0.04, 0.01, 1);
+    if(acq_len > 0)
+      clockrec->set_acquisition(acq_gain, acq_len);
+    if(preamble_sync) {
+      corr->set_freq_estimate(true);
+      gr::ais::burst_derotator_cc::sptr derotate =
+        gr::ais::burst_derotator_cc::make((int) ceil(1280*sps));
+      tb->connect(corr, 0, derotate, 0);
+      tb->connect(derotate, 0, clockrec, 0);
+    }
+    else
+      tb->connect(corr, 0, clockrec, 0);
+    if(detector == "viterbi") {
+      viterbi = gr::ais::gmsk_viterbi_cb::make();
+      tb->connect(clockrec, 0, viterbi, 0);
+      tb->connect(viterbi, 0, pack, 0);
+    }
+    else
+      tb->connect(clockrec, 0, disc, 0);
+  }
+  else if(chain == "sc16") {
+    corr16 = gr::ais::corr_est_sc16::make(preamble, sps, 1, threshold);
+    gr::ais::msk_timing_recovery_sc16::sptr clockrec =
+      gr::ais::msk_timing_recovery_sc16::make(sps, gain, 0.01, 1);
+    if(acq_len > 0)
+      clockrec->set_acquisition(acq_gain, acq_len);
+    gr::blocks::interleaved_short_to_complex::sptr tofloat =
+      gr::blocks::interleaved_short_to_complex::make(true);
+    tb->connect(head, 0, corr16, 0);
+    tb->connect(corr16, 0, clockrec, 0);
+    tb->connect(clockrec, 0, tofloat, 0);
+    tb->connect(tofloat, 0, disc, 0);
+  }
+  else {
+    corr = gr::ais::corr_est_cc::make(preamble, sps, 1, threshold);
+    gr::ais::msk_timing_recovery_cc::sptr clockrec =
+      gr::ais::msk_timing_recovery_cc::make(sps, gain, 0.01, 1);
+    if(acq_len > 0)
+      clockrec->set_acquisition(acq_gain, acq_len);
+    tb->connect(head, 0, corr, 0);
+    tb->connect(corr, 0, clockrec, 0);
+    tb->connect(clockrec, 0, disc, 0);
+  }
+  if(chain != "fused" && !viterbi) {
+    tb->connect(disc, 0, slicer, 0);
+    tb->connect(slicer, 0, diff, 0);
+    tb->connect(diff, 0, inv, 0);
+    tb->connect(inv, 0, pack, 0);
+  }
+  gr::ais::hdlc_deframer_bp::sptr deframer = gr::ais::hdlc_deframer_bp::make(11, 64);
+  frame_counter::sptr counter(new frame_counter(sent));
+  tb->connect(pack, 0, deframer, 0);
+  tb->msg_connect(deframer, "out", counter, "in");
+
+  std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+  tb->run();
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  if(file)
+    unlink(path);
+
+  char acq[64] = "off";
+  if(acq_len > 0)
+    snprintf(acq, sizeof(acq), "%.2f for %d symbols", acq_gain, acq_len);
+  printf("%s chain%s%s, %d sps, acquisition %s, %s frequency sync: "
+         "%.1f s of signal in %.3f s, %.0fx real time\n",
+         chain.c_str(), burst_agc ? " with burst AGC" : "",
+         viterbi ? " with Viterbi detector" : "", sps, acq,
+         !sync || file ? "no" : freq_sync.c_str(),
+         len/rate, secs, len/rate/secs);
+  printf("Eb/N0 %.1f dB, offset %.0f Hz: %d of %d frames lost, PER %.3f (%d bad frames passed)\n",
+         snr, offset, nframes - counter->good(), nframes,
+         (double)(nframes - counter->good())/nframes, counter->bad());
+  printf("%lu preamble detections\n",
+         (unsigned long)(demod ? demod->detections()
+                         : corr16 ? corr16->detections() : corr->detections()));
+  if(viterbi)
+    printf("%lu Viterbi resets\n", (unsigned long) viterbi->resets());
+  return 0;
+}
@@ -0,0 +1,324 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * ais_bench_sync: throughput of square_and_fft_sync_cc against the
+ * gmsk_sync chain it replaced.
+ *
+ * Modulates random symbols as AIS GMSK (BT 0.4) at 48 kHz, adds a
+ * carrier offset and white noise, and runs it through the seven blocks
+ * python/gmsk_sync.py wires (squarer, stream_to_vector, fft_vcc,
+ * freqest, repeat, frequency_modulator_fc and mixer) and then through
+ * square_and_fft_sync_cc, each in a flowgraph of its own. freqest now
+ * shares its estimator with square_and_fft_sync_cc, so the chain runs a
+ * copy of freqest's loop as it was instead. Reports samples per second
+ * for each, and checks that both make the same frequency estimates: the
+ * chain's are read from the copy's output, the block's from the phase
+ * step of its derotator over each FFT length, which leaves the last of
+ * them to compare exactly through freq().
+ */
+
+#include <gnuradio/top_block.h>
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/blocks/vector_source.h>
+#include <gnuradio/blocks/vector_sink.h>
+#include <gnuradio/blocks/multiply.h>
+#include <gnuradio/blocks/stream_to_vector.h>
+#include <gnuradio/blocks/repeat.h>
+#include <gnuradio/fft/fft_vcc.h>
+#include <gnuradio/fft/window.h>
+#include <gnuradio/analog/frequency_modulator_fc.h>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/sync_block.h>
+#include <ais/square_and_fft_sync_cc.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <getopt.h>
+
+namespace {
+
+  const double bits_per_sec = 9600.0;
+  const double samplerate = 48000.0;
+  const int sps = 5;
+  const double bt = 0.4;
+  const double span = 2.0; // of the frequency pulse either side, in symbols
+
+  // Phase pulse: the frequency pulse integrated from its start to t
+  // symbols from its centre, scaled to end at 1
+  double
+  phase_pulse(double t)
+  {
+    const double k = 2*M_PI*bt/sqrt(log(2.0))/M_SQRT2;
+    const int steps = 256;
+    double total = 0, part = 0;
+    for(int i = 0; i < 2*span*steps; i++) {
+      double u = -span + (i + 0.5)/steps;
+      double g = erfc(k*(u - 0.5)) - erfc(k*(u + 0.5));
+      total += g;
+      if(u < t)
+        part += g;
+    }
+    return part/total;
+  }
+
+  // n samples at sps per symbol and unit amplitude; freq in radians per
+  // sample, sigma of noise per component
+  std::vector<gr_complex>
+  modulate(int n, double freq, double sigma, std::mt19937 &rng)
+  {
+    const int reach = (int) ceil(span) + 1;
+    std::vector<double> q(2*reach*sps + 1);
+    for(size_t i = 0; i < q.size(); i++)
+      q[i] = phase_pulse((double) i/sps - reach);
+
+    const int nsym = n/sps + 2*reach;
+    std::vector<int> sym(nsym);
+    for(int k = 0; k < nsym; k++)
+      sym[k] = (rng() & 1) ? 1 : -1;
+
+    std::normal_distribution<double> noise(0, sigma);
+    std::vector<gr_complex> x(n);
+    double done = 0; // symbols whose pulse has passed
+    int passed = 0;
+    for(int s = 0; s < n; s++) {
+      double ph = done;
+      for(int i = passed; i < nsym; i++) {
+        int u = s - i*sps + reach*sps;
+        if(u < 0)
+          break;
+        if(u >= (int) q.size() - 1) {
+          done += sym[i];
+          passed = i + 1;
+          ph += sym[i];
+        }
+        else
+          ph += sym[i]*q[u];
+      }
+      ph = M_PI/2*ph + freq*s;
+      x[s] = gr_complex(cos(ph) + noise(rng), sin(ph) + noise(rng));
+    }
+    return x;
+  }
+
+  /*
+   * freqest as it was before square_and_fft_sync_cc, the loop verbatim
+   */
+  class baseline_freqest : public gr::sync_block
+  {
+    float d_binsize;
+    int d_offset;
+
+  public:
+    typedef boost::shared_ptr<baseline_freqest> sptr;
+
+    baseline_freqest(float sample_rate, int data_rate, int fftlen)
+      : gr::sync_block("baseline_freqest",
+                       gr::io_signature::make(1, 1, sizeof(gr_complex) * fftlen),
+                       gr::io_signature::make(1, 1, sizeof(float)))
+    {
+        d_offset = fftlen * (float(data_rate) / float(sample_rate));
+        d_binsize = float(sample_rate) / float(fftlen);
+    }
+
+    int work(int noutput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items)
+    {
+        const gr_complex *in = (const gr_complex *) input_items[0];
+        float *out = (float *) output_items[0];
+
+        unsigned int fftlen = input_signature()->sizeof_stream_item(0) / sizeof(gr_complex);
+
+        float maxenergy = 0;
+        unsigned int maxpos = 0;
+        float currentenergy;
+
+        //you are responsible for organizing the vector
+        for (int i = 0; i < noutput_items; i++) {
+            //for each requested output item
+            maxenergy = 0;
+            for(unsigned int j = 0; j < fftlen - d_offset; j++) {
+                //over the entire fft up until the right side of the "window" butts up against the end
+                currentenergy = std::abs(in[i*fftlen+j]) + std::abs(in[i*fftlen+j+d_offset]); //sum of the two bins at -datarate/2 and +datarate/2
+                if(currentenergy > maxenergy) {
+                    maxenergy = currentenergy;
+                    maxpos = j + d_offset/2; //add the offset to find the center position
+                }
+            }
+            //now maxpos contains the center bin, and we must translate that to a frequency offset
+            out[i] = (float(maxpos) - fftlen/2) * d_binsize/2; //subtract fftlen/2 to center the complex FFT around 0
+        }
+
+        return noutput_items;
+    }
+  };
+
+  // The correction applied to each fftlen samples, in Hz, from the mean
+  // phase step of out/in across them
+  std::vector<double>
+  applied(const std::vector<gr_complex> &in, const std::vector<gr_complex> &out,
+          int fftlen)
+  {
+    std::vector<double> f;
+    for(size_t b = 0; b + fftlen <= out.size(); b += fftlen) {
+      std::complex<double> acc = 0, last = 0;
+      for(int i = 0; i < fftlen; i++) {
+        std::complex<double> r = std::complex<double>(out[b+i])*
+          std::conj(std::complex<double>(in[b+i]));
+        if(i)
+          acc += r*std::conj(last);
+        last = r;
+      }
+      f.push_back(-std::arg(acc)*samplerate/(2*M_PI));
+    }
+    return f;
+  }
+
+  double
+  seconds_to_run(gr::top_block_sptr tb)
+  {
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    tb->run();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  }
+
+  void
+  usage(const char *prog)
+  {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "Time square_and_fft_sync_cc against the gmsk_sync chain.\n"
+            "  -n, --samples <n>      samples to run [default=4800000]\n"
+            "  -s, --snr <dB>         Es/N0 [default=10]\n"
+            "  -f, --offset <Hz>      carrier offset [default=1000]\n"
+            "  -l, --fftlen <n>       FFT length [default=1024]\n",
+            prog);
+  }
+
+} // anonymous namespace
+
+int
+main(int argc, char **argv)
+{
+  int nsamples = 4800000, fftlen = 1024;
+  double snr = 10, offset = 1000;
+
+  static const struct option longopts[] = {
+    {"samples", required_argument, 0, 'n'},
+    {"snr", required_argument, 0, 's'},
+    {"offset", required_argument, 0, 'f'},
+    {"fftlen", required_argument, 0, 'l'},
+    {"help", no_argument, 0, 'h'},
+    {0, 0, 0, 0}
+  };
+  int opt;
+  while((opt = getopt_long(argc, argv, "n:s:f:l:h", longopts, 0)) != -1) {
+    switch(opt) {
+    case 'n': nsamples = atoi(optarg); break;
+    case 's': snr = atof(optarg); break;
+    case 'f': offset = atof(optarg); break;
+    case 'l': fftlen = atoi(optarg); break;
+    default: usage(argv[0]); return opt == 'h' ? 0 : 1;
+    }
+  }
+  if(optind != argc || fftlen < 16 || nsamples < 2*fftlen) {
+    usage(argv[0]);
+    return 1;
+  }
+  nsamples -= nsamples % fftlen;
+
+  std::mt19937 rng(1);
+  const double sigma = sqrt(0.5*sps/pow(10.0, snr/10));
+  std::vector<gr_complex> x = modulate(nsamples, 2*M_PI*offset/samplerate,
+                                       sigma, rng);
+
+  // As gmsk_sync.square_and_fft_sync_cc wires it
+  gr::top_block_sptr tb = gr::make_top_block("ais_bench_sync_chain");
+  gr::blocks::vector_source<gr_complex>::sptr src =
+    gr::blocks::vector_source<gr_complex>::make(x);
+  gr::blocks::multiply_cc::sptr square = gr::blocks::multiply_cc::make(1);
+  gr::blocks::stream_to_vector::sptr fftvect =
+    gr::blocks::stream_to_vector::make(sizeof(gr_complex), fftlen);
+  gr::fft::fft_vcc::sptr fft =
+    gr::fft::fft_vcc::make(fftlen, true, gr::fft::window::rectangular(fftlen), true);
+  baseline_freqest::sptr freqest(new baseline_freqest(samplerate, int(bits_per_sec), fftlen));
+  gr::blocks::repeat::sptr repeat = gr::blocks::repeat::make(sizeof(float), fftlen);
+  gr::analog::frequency_modulator_fc::sptr fm =
+    gr::analog::frequency_modulator_fc::make(-1.0/(samplerate/(2*M_PI)));
+  gr::blocks::multiply_cc::sptr mix = gr::blocks::multiply_cc::make(1);
+  gr::blocks::vector_sink<float>::sptr est = gr::blocks::vector_sink<float>::make();
+  gr::blocks::vector_sink<gr_complex>::sptr chain_out =
+    gr::blocks::vector_sink<gr_complex>::make(1, nsamples);
+  tb->connect(src, 0, square, 0);
+  tb->connect(src, 0, square, 1);
+  tb->connect(src, 0, mix, 0);
+  tb->connect(square, 0, fftvect, 0);
+  tb->connect(fftvect, 0, fft, 0);
+  tb->connect(fft, 0, freqest, 0);
+  tb->connect(freqest, 0, repeat, 0);
+  tb->connect(freqest, 0, est, 0);
+  tb->connect(repeat, 0, fm, 0);
+  tb->connect(fm, 0, mix, 1);
+  tb->connect(mix, 0, chain_out, 0);
+  double chain_secs = seconds_to_run(tb);
+
+  tb = gr::make_top_block("ais_bench_sync_block");
+  src = gr::blocks::vector_source<gr_complex>::make(x);
+  gr::ais::square_and_fft_sync_cc::sptr sync =
+    gr::ais::square_and_fft_sync_cc::make(samplerate, int(bits_per_sec), fftlen);
+  gr::blocks::vector_sink<gr_complex>::sptr block_out =
+    gr::blocks::vector_sink<gr_complex>::make(1, nsamples);
+  tb->connect(src, 0, sync, 0);
+  tb->connect(sync, 0, block_out, 0);
+  double block_secs = seconds_to_run(tb);
+
+  // The chain's estimates exactly; the block's to within the precision
+  // of reading them back from its output
+  std::vector<float> chain_est = est->data();
+  std::vector<double> block_est = applied(x, block_out->data(), fftlen);
+  size_t n = std::min(chain_est.size(), block_est.size());
+  int agree = 0;
+  double worst = 0;
+  for(size_t k = 0; k < n; k++) {
+    double d = fabs(block_est[k] - chain_est[k]);
+    worst = std::max(worst, d);
+    agree += d < 0.05*samplerate/fftlen;
+  }
+  bool last = !chain_est.empty() && sync->freq() == chain_est.back();
+
+  printf("%d samples at %.0f kHz, fftlen %d\n", nsamples, samplerate/1e3,
+         fftlen);
+  printf("  gmsk_sync chain:        %.2f Msamples/s, %.0fx real time\n",
+         nsamples/chain_secs/1e6, nsamples/chain_secs/samplerate);
+  printf("  square_and_fft_sync_cc: %.2f Msamples/s, %.0fx real time\n",
+         nsamples/block_secs/1e6, nsamples/block_secs/samplerate);
+  printf("Estimates (offset %.0f Hz, Es/N0 %.1f dB): %d of %zu agree, "
+         "worst %.3f Hz apart; last %s (%.3f Hz)\n",
+         offset, snr, agree, n, worst, last ? "identical" : "DIFFERS",
+         chain_est.empty() ? 0.0 : chain_est.back());
+  return last && agree == (int) n ? 0 : 1;
+}
@@ -0,0 +1,348 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * ais_bench_timing: throughput of msk_timing_recovery_cc's interpolator.
+ *
+ * Modulates random symbols as AIS GMSK (BT 0.4) at the chosen samples
+ * per symbol and amplitude 1.5, about where ais_demod's AGC (which
+ * levels the peaks of signal and noise to 2) leaves them, adds
+ * white noise and averages over a symbol in place of the channel filter,
+ * and runs that through the timing loop in a flowgraph:
+ * once through a copy of the loop as it was, calling
+ * mmse_fir_interpolator_cc at every half-symbol step, and then through
+ * msk_timing_recovery_cc with each of its interpolators. Reports samples
+ * per second for each, how many outputs match the copy's exactly, and
+ * the bit error rate of ais_demod's discriminator, slicer and
+ * differential decoder after it.
+ */
+
+#include <gnuradio/top_block.h>
+#include <gnuradio/block.h>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/math.h>
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/blocks/vector_source.h>
+#include <gnuradio/blocks/vector_sink.h>
+#include <gnuradio/filter/mmse_fir_interpolator_cc.h>
+#include <ais/msk_timing_recovery_cc.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include <getopt.h>
+
+namespace {
+
+  const double bits_per_sec = 9600.0;
+  const double bt = 0.4;
+  const double span = 2.0; // of the frequency pulse either side, in symbols
+  const double amplitude = 1.5;
+
+  // Phase pulse: the frequency pulse integrated from its start to t
+  // symbols from its centre, scaled to end at 1
+  double
+  phase_pulse(double t)
+  {
+    const double k = 2*M_PI*bt/sqrt(log(2.0))/M_SQRT2;
+    const int steps = 256;
+    double total = 0, part = 0;
+    for(int i = 0; i < 2*span*steps; i++) {
+      double u = -span + (i + 0.5)/steps;
+      double g = erfc(k*(u - 0.5)) - erfc(k*(u + 0.5));
+      total += g;
+      if(u < t)
+        part += g;
+    }
+    return part/total;
+  }
+
+  // sps samples per symbol, sigma of noise per component,
+  // then a moving average over a symbol
+  std::vector<gr_complex>
+  modulate(const std::vector<int> &sym, int sps, double sigma, std::mt19937 &rng)
+  {
+    const int reach = (int) ceil(span) + 1;
+    std::vector<double> q(2*reach*sps + 1);
+    for(size_t i = 0; i < q.size(); i++)
+      q[i] = phase_pulse((double) i/sps - reach);
+
+    std::normal_distribution<double> noise(0, sigma);
+    const int nsym = sym.size();
+    std::vector<gr_complex> x(nsym*sps);
+    double done = 0; // symbols whose pulse has passed
+    int passed = 0;
+    for(size_t s = 0; s < x.size(); s++) {
+      double ph = done;
+      for(int i = passed; i < nsym; i++) {
+        int u = s - i*sps + reach*sps;
+        if(u < 0)
+          break;
+        if(u >= (int) q.size() - 1) {
+          done += sym[i];
+          passed = i + 1;
+          ph += sym[i];
+        }
+        else
+          ph += sym[i]*q[u];
+      }
+      ph *= M_PI/2;
+      x[s] = gr_complex(amplitude*cos(ph) + noise(rng), amplitude*sin(ph) + noise(rng));
+    }
+
+    std::vector<gr_complex> y(x.size());
+    gr_complex sum = 0;
+    for(size_t s = 0; s < x.size(); s++) {
+      sum += x[s];
+      if(s >= (size_t) sps)
+        sum -= x[s - sps];
+      y[s] = sum*(1.0f/sps);
+    }
+    return y;
+  }
+
+  /*
+   * msk_timing_recovery_cc's loop before batching, without the tag,
+   * gating and acquisition handling: one mmse_fir_interpolator_cc call
+   * per half-symbol step.
+   */
+  class per_step_loop : public gr::block
+  {
+    gr::filter::mmse_fir_interpolator_cc d_interp;
+    float d_sps, d_gain, d_gain_omega, d_limit;
+    float d_mu, d_omega;
+    gr_complex d_dly_conj_1, d_dly_conj_2, d_dly_diff_1;
+    int d_div;
+
+  public:
+    typedef boost::shared_ptr<per_step_loop> sptr;
+
+    per_step_loop(float sps, float gain, float limit)
+      : gr::block("per_step_loop",
+                  gr::io_signature::make(1, 1, sizeof(gr_complex)),
+                  gr::io_signature::make(1, 1, sizeof(gr_complex))),
+        d_sps(sps/2), d_gain(gain), d_gain_omega(gain*gain*0.25),
+        d_limit(limit), d_mu(0.5), d_omega(sps/2),
+        d_dly_conj_1(0), d_dly_conj_2(0), d_dly_diff_1(0), d_div(0)
+    {
+      set_relative_rate(1.0/sps);
+    }
+
+    int margin() const { return d_interp.ntaps() + (int) ceil(2*d_sps); }
+
+    void forecast(int noutput_items, gr_vector_int &ninput_items_required)
+    {
+      ninput_items_required[0] = (int) ceil(noutput_items*d_sps*2) + margin();
+    }
+
+    int general_work(int noutput_items, gr_vector_int &ninput_items,
+                     gr_vector_const_void_star &input_items,
+                     gr_vector_void_star &output_items)
+    {
+      const gr_complex *in = (const gr_complex *) input_items[0];
+      gr_complex *out = (gr_complex *) output_items[0];
+      int ninp = ninput_items[0] - margin();
+      int iidx = 0, oidx = 0;
+      while(oidx < noutput_items && iidx < ninp) {
+        const bool odd = d_div;
+        gr_complex in_interp = d_interp.interpolate(&in[iidx], d_mu);
+        gr_complex sq = in_interp*in_interp;
+        gr_complex dly_conj = std::conj(d_dly_conj_2*d_dly_conj_2);
+        gr_complex nlin_out = sq*dly_conj;
+        float err_out = std::real(nlin_out - d_dly_diff_1);
+        if(odd) {
+          err_out = gr::branchless_clip(err_out, 3.0);
+          d_omega += d_gain_omega*err_out;
+          d_omega  = d_sps + gr::branchless_clip(d_omega-d_sps, d_limit);
+          d_mu    += d_gain*err_out;
+        }
+        else
+          out[oidx++] = in_interp;
+        d_div = !odd;
+
+        d_dly_conj_1 = in_interp;
+        d_dly_conj_2 = d_dly_conj_1;
+        d_dly_diff_1 = nlin_out;
+
+        d_mu += d_omega;
+        float whole = floorf(d_mu);
+        iidx += (int) whole;
+        d_mu -= whole;
+      }
+      consume_each(std::max(0, iidx));
+      return oidx;
+    }
+  };
+
+  // Errors after slicing the phase step between outputs and taking the
+  // difference of successive decisions, as ais_demod, against the NRZI
+  // decoded symbols. The best of a few alignments, skipping the ends.
+  double
+  bit_error_rate(const std::vector<gr_complex> &y, const std::vector<int> &sym)
+  {
+    const int edge = 100;
+    int best = -1, compared = 0;
+    for(int lag = -8; lag <= 8; lag++) {
+      int errors = 0, n = 0;
+      for(int k = edge; k + edge < (int) y.size(); k++) {
+        int s = k + lag;
+        if(s < 1 || s >= (int) sym.size())
+          continue;
+        bool now = std::arg(y[k]*std::conj(y[k-1])) > 0;
+        bool before = std::arg(y[k-1]*std::conj(y[k-2])) > 0;
+        errors += (now != before) != (sym[s] != sym[s-1]);
+        n++;
+      }
+      if(best < 0 || errors < best) {
+        best = errors;
+        compared = n;
+      }
+    }
+    return compared ? (double) best/compared : 1.0;
+  }
+
+  // Seconds for the best of repeat runs of x through a new block from
+  // make, and the output
+  double
+  time_block(std::function<gr::basic_block_sptr()> make,
+             const std::vector<gr_complex> &x, int repeat, std::vector<gr_complex> &y)
+  {
+    double best = 0;
+    for(int r = 0; r < repeat; r++) {
+      gr::basic_block_sptr blk = make();
+      gr::top_block_sptr tb = gr::make_top_block("ais_bench_timing");
+      gr::blocks::vector_source<gr_complex>::sptr src =
+        gr::blocks::vector_source<gr_complex>::make(x);
+      gr::blocks::vector_sink<gr_complex>::sptr sink =
+        gr::blocks::vector_sink<gr_complex>::make(1, x.size());
+      tb->connect(src, 0, blk, 0);
+      tb->connect(blk, 0, sink, 0);
+      std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+      tb->run();
+      double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+      if(r == 0 || secs < best)
+        best = secs;
+      y = sink->data();
+    }
+    return best;
+  }
+
+  void
+  usage(const char *prog)
+  {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "Time msk_timing_recovery_cc's interpolators against the per-step MMSE loop.\n"
+            "  -n, --symbols <n>      symbols to run [default=2000000]\n"
+            "  -p, --sps <n>          samples per symbol [default=5]\n"
+            "  -s, --snr <dB>         Eb/N0 [default=17]\n"
+            "  -r, --repeat <n>       runs of each, the fastest counted [default=3]\n",
+            prog);
+  }
+
+} // anonymous namespace
+
+int
+main(int argc, char **argv)
+{
+  int nsym = 2000000, sps = 5, repeat = 3;
+  double snr = 17;
+
+  static const struct option longopts[] = {
+    {"symbols", required_argument, 0, 'n'},
+    {"sps", required_argument, 0, 'p'},
+    {"snr", required_argument, 0, 's'},
+    {"repeat", required_argument, 0, 'r'},
+    {"help", no_argument, 0, 'h'},
+    {0, 0, 0, 0}
+  };
+  int opt;
+  while((opt = getopt_long(argc, argv, "n:p:s:r:h", longopts, 0)) != -1) {
+    switch(opt) {
+    case 'n': nsym = atoi(optarg); break;
+    case 'p': sps = atoi(optarg); break;
+    case 's': snr = atof(optarg); break;
+    case 'r': repeat = atoi(optarg); break;
+    default: usage(argv[0]); return opt == 'h' ? 0 : 1;
+    }
+  }
+  if(optind != argc || nsym < 1 || sps < 2 || repeat < 1) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  std::mt19937 rng(1);
+  std::vector<int> sym(nsym);
+  for(int i = 0; i < nsym; i++)
+    sym[i] = (rng() & 1) ? 1 : -1;
+  // Eb/N0 over the samples of a bit
+  std::vector<gr_complex> x =
+    modulate(sym, sps, amplitude*sqrt(0.5*sps/pow(10.0, snr/10)), rng);
+  const double secs_of_signal = x.size()/(bits_per_sec*sps);
+
+  // as ais_demod
+  const float gain = 0.04, limit = 0.01;
+  std::vector<gr_complex> ref;
+  double t = time_block([&]() -> gr::basic_block_sptr {
+                          return per_step_loop::sptr(new per_step_loop(sps, gain, limit));
+                        }, x, repeat, ref);
+  printf("%d samples per symbol, %.0f s of signal\n", sps, secs_of_signal);
+  printf("%-16s %7.3f s  %6.2f Msamples/s  %5.0fx real time, BER %.2e\n",
+         "per-step copy", t, x.size()/t*1e-6, secs_of_signal/t,
+         bit_error_rate(ref, sym));
+
+  struct variant {
+    const char *name;
+    gr::ais::interp_type type;
+  };
+  const variant variants[] = {
+    {"mmse", gr::ais::INTERP_MMSE},
+    {"cubic", gr::ais::INTERP_CUBIC},
+    {"linear", gr::ais::INTERP_LINEAR}
+  };
+  for(size_t v = 0; v < sizeof(variants)/sizeof(variants[0]); v++) {
+    const variant &var = variants[v];
+    std::vector<gr_complex> y;
+    t = time_block([&]() -> gr::basic_block_sptr {
+                     gr::ais::msk_timing_recovery_cc::sptr clockrec =
+                       gr::ais::msk_timing_recovery_cc::make(sps, gain, limit, 1);
+                     clockrec->set_interpolator(var.type);
+                     return clockrec;
+                   }, x, repeat, y);
+
+    // The loop feeds back on its output, so one rounding difference
+    // (the compiler may fuse multiply-adds differently) puts the rest
+    // of the run on a slightly different trajectory
+    size_t n = std::min(y.size(), ref.size()), same = 0;
+    for(size_t i = 0; i < n; i++)
+      same += y[i] == ref[i];
+    printf("%-16s %7.3f s  %6.2f Msamples/s  %5.0fx real time, BER %.2e, "
+           "%.1f%% of outputs as the copy's\n",
+           var.name, t, x.size()/t*1e-6, secs_of_signal/t,
+           bit_error_rate(y, sym), n ? 100.0*same/n : 0.0);
+  }
+  return 0;
+}
@@ -0,0 +1,500 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * ais_decode_file: decode an IQ recording as fast as the machine allows.
+ *
+ * The recording (any format iq_file_source reads) is memory-mapped and
+ * cut into chunks which overlap by a short guard
+ * interval. Each chunk is run through its own copy of ais_rx's chain on a
+ * pool of worker threads. Each chunk keeps the frames whose opening flag
+ * falls in its core or just past either end; frames seen twice around a
+ * chunk boundary are then dropped, and the rest printed as NMEA in
+ * recording order, each prefixed by its time.
+ *
+ * With --sc16 a single-channel recording is kept as int16 from the file
+ * through corr_est_sc16 and msk_timing_recovery_sc16, at half the memory
+ * traffic of the float chain. That chain has no channel filter, AGC or
+ * frequency sync, so the recording must already be one channel at a low
+ * rate (2 to 5 samples per symbol, say), within a hundred or so Hz of
+ * the carrier, and the timing loop's gain is set for the burst amplitude
+ * given with --level.
+ */
+
+#include <gnuradio/top_block.h>
+#include <gnuradio/block.h>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/expj.h>
+#include <gnuradio/blocks/unpacked_to_packed.h>
+#include <gnuradio/blocks/interleaved_short_to_complex.h>
+#include <gnuradio/analog/quadrature_demod_cf.h>
+#include <gnuradio/digital/binary_slicer_fb.h>
+#include <gnuradio/digital/diff_decoder_bb.h>
+#include <gnuradio/filter/firdes.h>
+#include <gnuradio/filter/freq_xlating_fir_filter.h>
+#include <ais/iq_file_source.h>
+#include <ais/channelizer_ccf.h>
+#include <ais/square_and_fft_sync_cc.h>
+#include <ais/demod_cb.h>
+#include <ais/corr_est_cc.h>
+#include <ais/msk_timing_recovery_cc.h>
+#include <ais/invert.h>
+#include <ais/hdlc_deframer_bp.h>
+#include <ais/nmea_encoder.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <getopt.h>
+
+namespace {
+
+  const double bits_per_sec = 9600.0;
+  const int samples_per_symbol = 5;
+  // The timing error detector's output grows as the fourth power of the
+  // amplitude; without an AGC the int16 chain's loop gain is this over
+  // amplitude^4 (measured with ais_bench_demod)
+  const double gain_a4 = 1.0/16;
+
+  struct channel {
+    const char *designator;
+    double offset; // from the recording's centre frequency, Hz
+  };
+
+  struct frame {
+    uint64_t sample; // approximate start, in recording samples
+    int chan;
+    std::vector<uint8_t> data;
+  };
+
+  bool
+  frame_order(const frame &a, const frame &b)
+  {
+    return a.sample < b.sample || (a.sample == b.sample && a.chan < b.chan);
+  }
+
+  /*
+   * Keeps the frames hdlc_deframer_bp emits on one channel.
+   */
+  class frame_sink : public gr::block
+  {
+    int d_chan;
+    uint64_t d_origin;
+    double d_samples_per_bit;
+    std::vector<frame> &d_frames;
+    std::mutex &d_lock;
+    pmt::pmt_t d_offset_key;
+
+  public:
+    typedef boost::shared_ptr<frame_sink> sptr;
+
+    frame_sink(int chan, uint64_t origin, double samples_per_bit,
+               std::vector<frame> &frames, std::mutex &lock)
+      : gr::block("frame_sink",
+                  gr::io_signature::make(0, 0, 0),
+                  gr::io_signature::make(0, 0, 0)),
+        d_chan(chan), d_origin(origin), d_samples_per_bit(samples_per_bit),
+        d_frames(frames), d_lock(lock), d_offset_key(pmt::mp("offset"))
+    {
+      message_port_register_in(pmt::mp("in"));
+      set_msg_handler(pmt::mp("in"), boost::bind(&frame_sink::handle, this, _1));
+    }
+
+    void handle(pmt::pmt_t msg)
+    {
+      pmt::pmt_t meta = pmt::car(msg);
+      pmt::pmt_t vec = pmt::cdr(msg);
+      size_t len = pmt::length(vec);
+      const uint8_t *data = pmt::u8vector_elements(vec, len);
+
+      // The deframer marks the byte holding the end of the closing flag;
+      // step back over the payload, FCS and opening flag. Stuffed bits
+      // are not counted, which is well inside the dedup tolerance.
+      uint64_t end_bit = 8*(pmt::to_uint64(pmt::dict_ref(meta, d_offset_key,
+                                                         pmt::from_uint64(0))) + 1);
+      uint64_t nbits = 8*(len + 2) + 16;
+      uint64_t start_bit = end_bit > nbits ? end_bit - nbits : 0;
+
+      frame f;
+      f.sample = d_origin + (uint64_t) llround(start_bit*d_samples_per_bit);
+      f.chan = d_chan;
+      f.data.assign(data, data + len);
+
+      std::lock_guard<std::mutex> lock(d_lock);
+      d_frames.push_back(f);
+    }
+  };
+
+  /*
+   * The preamble template ais_demod correlates against: the training
+   * sequence 0101... and the start flag, NRZI coded from a level of +1,
+   * one symbol per bit, shaped with a Gaussian (BT 0.4) convolved with a
+   * rectangle and frequency modulated with sensitivity (pi/2)/sps, as
+   * digital.gmsk_mod does after unpacking.
+   */
+  std::vector<gr_complex>
+  preamble_symbols(int sps)
+  {
+    std::vector<float> bits;
+    float level = 1;
+    for(int i = 0; i < 32; i++) {
+      bool one = i < 24 ? (i & 1) : (i > 24 && i < 31); // training, flag
+      if(!one)
+        level = -level;
+      bits.push_back(level);
+    }
+
+    std::vector<float> gauss = gr::filter::firdes::gaussian(1, sps, 0.4, 4*sps);
+    std::vector<float> taps(gauss.size() + sps - 1, 0);
+    for(size_t i = 0; i < gauss.size(); i++)
+      for(int j = 0; j < sps; j++)
+        taps[i+j] += gauss[i];
+
+    size_t n = bits.size()*sps;
+    std::vector<gr_complex> out(n);
+    float sensitivity = (M_PI/2)/sps, phase = 0;
+    for(size_t i = 0; i < n; i++) {
+      float shaped = 0;
+      for(size_t k = 0; k <= i && k < taps.size(); k++)
+        if((i - k) % sps == 0)
+          shaped += taps[k]*bits[(i - k)/sps];
+      phase += sensitivity*shaped;
+      out[i] = gr_expj(phase);
+    }
+    return out;
+  }
+
+  struct decoder {
+    std::string filename;
+    gr::ais::iq_format format;
+    uint64_t nsamples;
+    double rate;
+    bool sc16;
+    double level;     // burst amplitude for the sc16 chain, of full scale
+    std::vector<channel> channels;
+    uint64_t chunk;   // core length, samples
+    uint64_t guard;   // extra either side, samples
+    uint64_t tolerance; // copies of a frame this close are one, samples
+    std::vector<std::vector<frame> > results;
+    std::atomic<size_t> next;
+
+    void run_chunk(size_t k);
+    void connect_float(gr::top_block_sptr tb, uint64_t begin, uint64_t len,
+                       std::vector<frame> &frames, std::mutex &lock);
+    void connect_sc16(gr::top_block_sptr tb, uint64_t begin, uint64_t len,
+                      std::vector<frame> &frames, std::mutex &lock);
+    void worker();
+  };
+
+  void
+  decoder::connect_float(gr::top_block_sptr tb, uint64_t begin, uint64_t len,
+                         std::vector<frame> &frames, std::mutex &lock)
+  {
+    gr::ais::iq_file_source::sptr src =
+      gr::ais::iq_file_source::make(filename, format, false, begin, len);
+    double samples_per_bit = rate/bits_per_sec;
+
+    // as ais_radio: one channelizer when the rate is on the channel grid,
+    // otherwise a separate filter per channel
+    bool channelized = fmod(rate, 25e3) == 0;
+    gr::ais::channelizer_ccf::sptr chan;
+    double chan_rate = bits_per_sec*samples_per_symbol;
+    int decim = (int)(rate/chan_rate);
+    if(channelized) {
+      std::vector<float> freqs;
+      for(size_t c = 0; c < channels.size(); c++)
+        freqs.push_back(channels[c].offset);
+      chan = gr::ais::channelizer_ccf::make(rate, freqs, chan_rate);
+      tb->connect(src, 0, chan, 0);
+    }
+    else {
+      chan_rate = rate/decim;
+    }
+    float sps = chan_rate/bits_per_sec;
+    std::vector<gr_complex> preamble = preamble_symbols((int) lrint(sps));
+
+    for(size_t c = 0; c < channels.size(); c++) {
+      gr::basic_block_sptr head;
+      int port = 0;
+      if(channelized) {
+        head = chan;
+        port = c;
+      }
+      else {
+        std::vector<float> taps = gr::filter::firdes::low_pass(1, rate, 11000, 1000);
+        head = gr::filter::freq_xlating_fir_filter_ccf::make(decim, taps,
+                                                             channels[c].offset,
+                                                             rate);
+        tb->connect(src, 0, head, 0);
+      }
+      gr::ais::square_and_fft_sync_cc::sptr sync =
+        gr::ais::square_and_fft_sync_cc::make(chan_rate, (int) bits_per_sec, 1024, false);
+      gr::ais::demod_cb::sptr demod =
+        gr::ais::demod_cb::make(preamble, sps, 1, 0.9, 0.04, 0.01);
+      gr::blocks::unpacked_to_packed_bb::sptr pack =
+        gr::blocks::unpacked_to_packed_bb::make(1, gr::GR_MSB_FIRST);
+      gr::ais::hdlc_deframer_bp::sptr deframer = gr::ais::hdlc_deframer_bp::make(11, 64);
+      frame_sink::sptr sink(new frame_sink(c, begin, samples_per_bit, frames, lock));
+
+      tb->connect(head, port, sync, 0);
+      tb->connect(sync, 0, demod, 0);
+      tb->connect(demod, 0, pack, 0);
+      tb->connect(pack, 0, deframer, 0);
+      tb->msg_connect(deframer, "out", sink, "in");
+    }
+  }
+
+  // the int16 chain: one channel, straight from the file
+  void
+  decoder::connect_sc16(gr::top_block_sptr tb, uint64_t begin, uint64_t len,
+                        std::vector<frame> &frames, std::mutex &lock)
+  {
+    float sps = rate/bits_per_sec;
+    gr::ais::iq_file_source::sptr src =
+      gr::ais::iq_file_source::make(filename, format, false, begin, len, true);
+    gr::ais::corr_est_sc16::sptr corr =
+      gr::ais::corr_est_sc16::make(preamble_symbols((int) lrint(sps)), sps, 1, 0.9);
+    gr::ais::msk_timing_recovery_sc16::sptr clockrec =
+      gr::ais::msk_timing_recovery_sc16::make(sps, gain_a4/pow(level, 4), 0.01, 1);
+    gr::blocks::interleaved_short_to_complex::sptr tofloat =
+      gr::blocks::interleaved_short_to_complex::make(true);
+    gr::analog::quadrature_demod_cf::sptr disc = gr::analog::quadrature_demod_cf::make(M_PI/2);
+    gr::digital::binary_slicer_fb::sptr slicer = gr::digital::binary_slicer_fb::make();
+    gr::digital::diff_decoder_bb::sptr diff = gr::digital::diff_decoder_bb::make(2);
+    gr::ais::invert::sptr inv = gr::ais::invert::make();
+    gr::blocks::unpacked_to_packed_bb::sptr pack =
+      gr::blocks::unpacked_to_packed_bb::make(1, gr::GR_MSB_FIRST);
+    gr::ais::hdlc_deframer_bp::sptr deframer = gr::ais::hdlc_deframer_bp::make(11, 64);
+    frame_sink::sptr sink(new frame_sink(0, begin, sps, frames, lock));
+
+    tb->connect(src, 0, corr, 0);
+    tb->connect(corr, 0, clockrec, 0);
+    tb->connect(clockrec, 0, tofloat, 0);
+    tb->connect(tofloat, 0, disc, 0);
+    tb->connect(disc, 0, slicer, 0);
+    tb->connect(slicer, 0, diff, 0);
+    tb->connect(diff, 0, inv, 0);
+    tb->connect(inv, 0, pack, 0);
+    tb->connect(pack, 0, deframer, 0);
+    tb->msg_connect(deframer, "out", sink, "in");
+  }
+
+  void
+  decoder::run_chunk(size_t k)
+  {
+    uint64_t core_begin = k*chunk;
+    uint64_t core_end = std::min(core_begin + chunk, nsamples);
+    uint64_t begin = core_begin > guard ? core_begin - guard : 0;
+    uint64_t end = std::min(core_end + guard, nsamples);
+
+    std::vector<frame> frames;
+    std::mutex lock;
+    double samples_per_bit = rate/bits_per_sec;
+
+    gr::top_block_sptr tb = gr::make_top_block("ais_decode_file");
+    if(sc16)
+      connect_sc16(tb, begin, end - begin, frames, lock);
+    else
+      connect_float(tb, begin, end - begin, frames, lock);
+    tb->run();
+
+    // Keep what starts in this chunk's core, and a margin either side:
+    // the start is estimated from the deframer's byte offset, whose byte
+    // alignment depends on where the chunk began, so two chunks can place
+    // a boundary frame up to a byte either side of each other. The copies
+    // this lets through are dropped as duplicates later.
+    uint64_t margin = tolerance + (uint64_t) ceil(16*samples_per_bit);
+    uint64_t keep_begin = core_begin > margin ? core_begin - margin : 0;
+    uint64_t keep_end = core_end + margin;
+    std::vector<frame> &mine = results[k];
+    for(size_t i = 0; i < frames.size(); i++)
+      if(frames[i].sample >= keep_begin && frames[i].sample < keep_end)
+        mine.push_back(frames[i]);
+  }
+
+  void
+  decoder::worker()
+  {
+    size_t nchunks = results.size();
+    for(size_t k = next++; k < nchunks; k = next++)
+      run_chunk(k);
+  }
+
+  void
+  usage(const char *prog)
+  {
+    fprintf(stderr,
+            "Usage: %s [options] <file>\n"
+            "Decode AIS from an I/Q recording centred on 162MHz.\n"
+            "  -f, --format <fmt>     cf32, cs8, cu8 or cs16 [default=by file name, or SigMF]\n"
+            "  -r, --rate <Hz>        sample rate [default=from SigMF, else 250k]\n"
+            "  -S, --singlechannel    the recording is centred on one channel, decode only it\n"
+            "  -i, --sc16             with -S, demodulate as int16, unfiltered and without AGC\n"
+            "  -L, --level <a>        with --sc16, burst amplitude as a fraction of full scale [default=0.25]\n"
+            "  -j, --jobs <n>         chunks to decode at once [default=number of CPUs]\n"
+            "  -c, --chunk <s>        chunk length in seconds [default=10]\n"
+            "  -t, --start <s>        time of the first sample, added to each timestamp [default=0]\n",
+            prog);
+  }
+
+} // anonymous namespace
+
+int
+main(int argc, char **argv)
+{
+  double rate = 0, chunk_secs = 10, start = 0, level = 0.25;
+  gr::ais::iq_format format = gr::ais::IQ_AUTO;
+  bool single = false, sc16 = false;
+  unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+
+  static const struct option longopts[] = {
+    {"format", required_argument, 0, 'f'},
+    {"rate", required_argument, 0, 'r'},
+    {"singlechannel", no_argument, 0, 'S'},
+    {"sc16", no_argument, 0, 'i'},
+    {"level", required_argument, 0, 'L'},
+    {"jobs", required_argument, 0, 'j'},
+    {"chunk", required_argument, 0, 'c'},
+    {"start", required_argument, 0, 't'},
+    {"help", no_argument, 0, 'h'},
+    {0, 0, 0, 0}
+  };
+  int opt;
+  while((opt = getopt_long(argc, argv, "f:r:SiL:j:c:t:h", longopts, 0)) != -1) {
+    switch(opt) {
+    case 'f':
+      if(!strcmp(optarg, "cf32")) format = gr::ais::IQ_CF32;
+      else if(!strcmp(optarg, "cs8")) format = gr::ais::IQ_CS8;
+      else if(!strcmp(optarg, "cu8")) format = gr::ais::IQ_CU8;
+      else if(!strcmp(optarg, "cs16")) format = gr::ais::IQ_CS16;
+      else { usage(argv[0]); return 1; }
+      break;
+    case 'r': rate = atof(optarg); break;
+    case 'S': single = true; break;
+    case 'i': sc16 = true; break;
+    case 'L': level = atof(optarg); break;
+    case 'j': jobs = std::max(1, atoi(optarg)); break;
+    case 'c': chunk_secs = atof(optarg); break;
+    case 't': start = atof(optarg); break;
+    default: usage(argv[0]); return opt == 'h' ? 0 : 1;
+    }
+  }
+  if(optind != argc-1 || chunk_secs <= 0 || (sc16 && !single)
+     || level <= 0 || level > 1) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  uint64_t nsamples;
+  try {
+    gr::ais::iq_file_source::sptr probe = gr::ais::iq_file_source::make(argv[optind], format);
+    nsamples = probe->nitems();
+    format = probe->format();
+    if(rate == 0)
+      rate = probe->sample_rate() > 0 ? probe->sample_rate() : 250e3;
+  }
+  catch(std::exception &e) {
+    fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+  if(rate < bits_per_sec*(sc16 ? 2 : samples_per_symbol)) {
+    usage(argv[0]);
+    return 1;
+  }
+  if(nsamples == 0)
+    return 0;
+
+  decoder d;
+  d.filename = argv[optind];
+  d.format = format;
+  d.nsamples = nsamples;
+  d.rate = rate;
+  d.sc16 = sc16;
+  d.level = level;
+  if(single) {
+    d.channels.push_back(channel{"A", 0});
+  }
+  else {
+    const channel all[] = {{"A", 161.975e6 - 162.0e6},
+                           {"B", 162.025e6 - 162.0e6}};
+    for(size_t c = 0; c < 2; c++)
+      if(fabs(all[c].offset) < rate/2 - 12.5e3)
+        d.channels.push_back(all[c]);
+  }
+  d.chunk = (uint64_t)(chunk_secs*rate);
+  // longer than a frame (~27ms) plus the filter, AGC and sync settling
+  d.guard = (uint64_t)(0.25*rate);
+  d.tolerance = (uint64_t)(0.01*rate);
+  d.results.resize((nsamples + d.chunk - 1)/d.chunk);
+  d.next = 0;
+
+  std::vector<std::thread> pool;
+  for(unsigned i = 0; i < std::min<size_t>(jobs, d.results.size()); i++)
+    pool.push_back(std::thread(&decoder::worker, &d));
+  for(size_t i = 0; i < pool.size(); i++)
+    pool[i].join();
+
+  std::vector<frame> frames;
+  for(size_t k = 0; k < d.results.size(); k++)
+    frames.insert(frames.end(), d.results[k].begin(), d.results[k].end());
+  std::stable_sort(frames.begin(), frames.end(), frame_order);
+
+  // Chunks either side of a boundary both keep frames near it, and place
+  // them a little differently.
+  const uint64_t tolerance = d.tolerance;
+  std::vector<gr::ais::nmea_encoder> encoders;
+  for(size_t c = 0; c < d.channels.size(); c++)
+    encoders.push_back(gr::ais::nmea_encoder(d.channels[c].designator));
+  std::vector<char> buf;
+  for(size_t i = 0; i < frames.size(); i++) {
+    const frame &f = frames[i];
+    bool dup = false;
+    for(size_t j = i; j-- > 0 && f.sample - frames[j].sample <= tolerance; )
+      if(frames[j].chan == f.chan && frames[j].data == f.data) {
+        dup = true;
+        break;
+      }
+    if(dup)
+      continue;
+
+    const gr::ais::nmea_encoder &enc = encoders[f.chan];
+    buf.resize(enc.max_length(f.data.size()));
+    size_t n = enc.encode(&f.data[0], f.data.size(), &buf[0], buf.size());
+    double t = start + f.sample/rate;
+    // one timestamp per sentence of a multi-sentence message
+    size_t pos = 0;
+    while(pos < n) {
+      const char *line = &buf[pos];
+      const char *nl = (const char *) memchr(line, '\n', n - pos);
+      size_t len = nl ? nl - line : n - pos;
+      printf("%.6f %.*s\n", t, (int) len, line);
+      pos += len + 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,71 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef INCLUDED_AIS_BURST_DEROTATOR_CC_H
+#define INCLUDED_AIS_BURST_DEROTATOR_CC_H
+
+#include <ais/api.h>
+#include <gnuradio/sync_block.h>
+
+namespace gr {
+  namespace ais {
+
+    /*!
+     * \brief Per-burst frequency correction from correlator estimates
+     * \ingroup ais
+     *
+     * \details
+     * Looks for the frequency estimate corr_est_cc attaches to each
+     * detection, either a "freq_est" tag or the freq_est field of a
+     * "corr_det" record (the tags need corr_est_cc's
+     * set_freq_estimate(true)), and derotates the \p burst_len samples
+     * from the tag on by it. Outside a burst the input passes through untouched. A
+     * detection inside a burst restarts the window with the new estimate;
+     * the phase stays continuous across it.
+     *
+     * With this after corr_est_cc, no continuous frequency loop such as
+     * square_and_fft_sync_cc is needed ahead of the correlator, as long as
+     * the carrier offset is small enough for the preamble still to be
+     * detected.
+     */
+    class AIS_API burst_derotator_cc : virtual public gr::sync_block
+    {
+     public:
+      typedef boost::shared_ptr<burst_derotator_cc> sptr;
+
+      /*!
+       * \brief Return a shared_ptr to a new instance of ais::burst_derotator_cc.
+       *
+       * \param burst_len Samples to correct after each estimate
+       */
+      static sptr make(int burst_len);
+
+      virtual void set_burst_len(int burst_len) = 0;
+      virtual int burst_len() const = 0;
+
+      //! Frequency estimate in use, in radians per sample
+      virtual float freq() const = 0;
+    };
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_AIS_BURST_DEROTATOR_CC_H */
@@ -0,0 +1,73 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIS_CHANNELIZER_CCF_H
+#define INCLUDED_AIS_CHANNELIZER_CCF_H
+
+#include <ais/api.h>
+#include <gnuradio/block.h>
+
+namespace gr {
+  namespace ais {
+
+    /*!
+     * \brief Pulls several narrow channels out of one wideband stream
+     * \ingroup ais
+     *
+     * \details
+     * A polyphase filterbank over an M = samp_rate/spacing point channel
+     * grid. The branch filters run once per output sample whatever the
+     * number of channels, and each channel then costs one M-point dot
+     * product against its DFT bin plus a rotation, so AIS A and B (and the
+     * ASM and long-range channels if wanted) come out of a single pass
+     * over the input. Each channel is then brought to exactly \p out_rate
+     * by its own polyphase arbitrary resampler.
+     *
+     * There is one output per entry of \p freqs, each the offset of a
+     * channel centre from the input centre frequency, which must be a
+     * multiple of \p spacing. \p samp_rate must be a multiple of \p spacing.
+     */
+    class AIS_API channelizer_ccf : virtual public gr::block
+    {
+     public:
+      typedef boost::shared_ptr<channelizer_ccf> sptr;
+
+      /*!
+       * \brief Make a channelizer.
+       *
+       * \param samp_rate: Input sample rate
+       * \param freqs: Channel centre offsets, Hz
+       * \param out_rate: Output sample rate of every channel
+       * \param spacing: Channel grid spacing, Hz
+       */
+      static sptr make(double samp_rate, const std::vector<float> &freqs,
+                       double out_rate, double spacing=25e3);
+
+      //! The prototype lowpass filter
+      virtual std::vector<float> taps() const = 0;
+
+      //! Integer decimation ahead of the resamplers
+      virtual int decimation() const = 0;
+    };
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_AIS_CHANNELIZER_CCF_H */
@@ -0,0 +1,74 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef INCLUDED_AIS_CORR_DETECTION_H
+#define INCLUDED_AIS_CORR_DETECTION_H
+
+#include <ais/api.h>
+#include <pmt/pmt.h>
+#include <cstring>
+
+namespace gr {
+  namespace ais {
+
+    /*!
+     * \brief One correlator detection, as produced by corr_est_cc.
+     * \ingroup ais
+     *
+     * \details
+     * Carried as a "corr_det" stream tag (one record in a blob) or as a
+     * batch of records in a single blob on corr_est_cc's "detections"
+     * message port.
+     */
+    struct corr_detection
+    {
+      uint64_t offset; //!< absolute position of the start of the sync word
+      float peak;      //!< correlator output power at the peak
+      float time_est;  //!< fractional sample timing offset of the peak
+      float phase_est; //!< carrier phase at the peak
+      float noise;     //!< running correlator noise power estimate
+      float freq_est;  //!< carrier offset over the sync word, rad/sample
+      int32_t freq_bin; //!< Doppler bank hypothesis of the peak, 0 without
+      float amp_est;   //!< signal amplitude, from the peak and template energy
+    };
+
+    //! Pack one detection into a blob PMT.
+    inline pmt::pmt_t
+    corr_detection_to_pmt(const corr_detection &det)
+    {
+      return pmt::make_blob(&det, sizeof(det));
+    }
+
+    //! Unpack a "corr_det" tag value; returns false if it isn't one.
+    inline bool
+    corr_detection_from_pmt(const pmt::pmt_t &blob, corr_detection &det)
+    {
+      if(!pmt::is_blob(blob) || pmt::blob_length(blob) != sizeof(det))
+        return false;
+      memcpy(&det, pmt::blob_data(blob), sizeof(det));
+      return true;
+    }
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_AIS_CORR_DETECTION_H */
+
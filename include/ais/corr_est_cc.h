@@ -25,27 +25,80 @@
 
 #include <ais/api.h>
 #include <gnuradio/sync_block.h>
+#include <volk/volk_complex.h>
 
 namespace gr {
   namespace ais {
 
+    /*!
+     * Correlator threshold methods. THRESHOLD_ABSOLUTE compares against a
+     * fixed fraction of the template's autocorrelation peak;
+     * THRESHOLD_CFAR scales a running estimate of the correlator's noise
+     * floor to hold a constant false-alarm rate.
+     */
+    enum tm_type {
+      THRESHOLD_ABSOLUTE,
+      THRESHOLD_CFAR
+    };
+
+    /*!
+     * Correlator implementations. CORR_ENGINE_FFT is an overlap-save FFT
+     * filter, which is cheapest for long templates but only works on whole
+     * FFT blocks. CORR_ENGINE_DIRECT is a SIMD direct-form dot product with
+     * no block size constraint. CORR_ENGINE_AUTO picks whichever is
+     * cheaper and fits the latency budget.
+     */
+    enum corr_engine_type {
+      CORR_ENGINE_AUTO,
+      CORR_ENGINE_FFT,
+      CORR_ENGINE_DIRECT
+    };
+
+    /*!
+     * How detections are reported. DETECT_TAGS emits the separate
+     * corr_start, phase_est, time_est and corr_est tags. DETECT_RECORD
+     * emits a single "corr_det" tag holding an ais::corr_detection.
+     * DETECT_MESSAGE posts all of a call's detections as one blob of
+     * ais::corr_detection records on the "detections" message port.
+     */
+    enum det_format_type {
+      DETECT_TAGS,
+      DETECT_RECORD,
+      DETECT_MESSAGE
+    };
+
     /*!
      * \brief Correlate stream with a pre-defined sequence and estimate peak
      * \ingroup synchronizers_blk
      *
      * \details
      * Input:
-     * \li Stream of complex samples.
+     * \li Stream of complex samples: float (corr_est_cc), or interleaved
+     *     int16 with full scale at 1.0 (corr_est_sc16).
      *
      * Output:
      * \li Output stream that just passes the input complex samples
      * \li tag 'phase_est': estimate of phase offset
      * \li tag 'time_est': estimate of symbol timing offset
      * \li tag 'corr_est': the correlation value of the estimates
+     * \li tag 'freq_est': estimate of carrier frequency offset, in
+     *     radians per sample (with set_freq_estimate())
+     * \li tag 'freq_bin': with a Doppler bank, the hypothesis the peak
+     *     was found in (with set_freq_estimate())
+     * \li tag 'amp_est': estimate of the burst's amplitude (with
+     *     set_burst_agc())
      * \li tag 'corr_start': the start sample of the correlation and the value
      *
      * \li Optional 2nd output stream providing the advanced correlator output
      *
+     * If no output is connected, the block does not copy its input at
+     * all, and detections are posted to the "detections" message port
+     * whatever the detection format. The record offsets are then positions
+     * in the block's input stream rather than its output, so downstream
+     * blocks can read the same input directly and line up against them.
+     * In all cases the time_est estimate applies mark_delay samples after
+     * a record's offset.
+     *
      * This block is designed to search for a sync word by correlation
      * and uses the results of the correlation to get a time and phase
      * offset estimate. These estimates are passed downstream as
@@ -81,11 +134,86 @@ namespace gr {
      * via Discrete-Time 'Analytic' Cross-Correlation, _IEEE_Transcations_
      * _on_Signal_Processing_, Volume 47, No. 9, September 1999
      *
+     * In THRESHOLD_CFAR mode the block keeps a running estimate of the
+     * mean correlator output power over stretches without a detection,
+     * and declares a detection when the output exceeds -ln(threshold)
+     * times that estimate, i.e. \p threshold is the per-sample
+     * probability of false alarm for a noise-only input. After a
+     * detection, no further detection is made until the correlator output
+     * falls below the hysteresis fraction of the threshold; crossings
+     * rejected this way are counted by rearm_crossings().
+     *
+     * The frequency estimate is data-aided: the sync word is split into
+     * two-symbol segments, each is correlated against its part of the
+     * template, and the phase advance from one segment to the next gives
+     * the offset. It is made only at detections that ask for it (records,
+     * or tags after set_freq_estimate(true)), is unambiguous to a
+     * quarter of the symbol rate (2400 Hz for AIS), and lets a
+     * burst_derotator_cc correct each burst without an always-on
+     * frequency loop. The detection itself is still a coherent
+     * full-template correlation, though, whose output power halves at an
+     * offset of about 0.44 over the sync word's duration (150 Hz for the
+     * AIS preamble); that, not the estimator, bounds the offsets this
+     * can handle.
+     *
+     * For carrier offsets beyond that, set_doppler_bank() correlates
+     * against a bank of frequency-shifted copies of the template and
+     * detects on the strongest. The input goes through one forward FFT
+     * per block, and each hypothesis is the template's spectrum shifted
+     * by a whole number of bins, so a hypothesis costs a spectral product
+     * and an inverse FFT rather than a full correlator. Hypotheses are
+     * spaced at about half the template's coherent bandwidth (at most
+     * ~1 dB loss between them). The peak's hypothesis is reported as
+     * freq_bin, and freq_est is that hypothesis refined by the segment
+     * estimator above.
+     *
+     * The whole bank only runs on blocks where a prefilter finds
+     * something: the input times its own conjugate two symbols earlier,
+     * correlated against the same product of the template. A carrier
+     * offset leaves that product with a constant phase, so one such
+     * correlation covers every offset, and other blocks cost two FFT
+     * correlations (the prefilter and the zero-offset hypothesis) rather
+     * than one per hypothesis. The product squares the noise, which
+     * costs the prefilter sensitivity at low SNR: a burst well below
+     * the level the demodulator can decode may be passed over. With CFAR
+     * thresholds the noise floor is kept on the zero-offset hypothesis,
+     * and where the whole bank runs the threshold is scaled by the mean
+     * of the strongest of its noise-only hypotheses.
+     *
+     * The correlation peak also measures the burst's amplitude: the
+     * square root of the peak power over the template's energy. With
+     * set_burst_agc(), the pass-through output of each burst is scaled by
+     * that estimate to a reference amplitude, for burst_len samples from
+     * the start of the sync word, so no AGC is needed ahead of the block.
+     * Samples outside bursts pass unscaled. Without an AGC ahead, the
+     * absolute threshold no longer means anything; use THRESHOLD_CFAR.
+     *
+     * corr_est_sc16 passes int16 samples through at half the memory
+     * traffic of corr_est_cc. Its direct-form correlator is fixed point:
+     * the template is quantized to as many fractional bits as leave the
+     * 32 bit accumulators room for a full-scale input (5 for the AIS
+     * preamble), so it cannot overflow. The FFT correlator converts to
+     * float internally. Thresholds and reported values are in the same
+     * units as corr_est_cc's.
+     *
+     * The setters are safe to call while the flowgraph runs: each builds
+     * a complete new configuration (kernels, FFT plans and all) and hands
+     * it over for work() to pick up at its next call, so work() never
+     * waits on a lock. The same settings can be sent as a dict to the
+     * "config" message port, with keys "symbols", "threshold",
+     * "hysteresis", "freq_est", "doppler", "agc_reference" and
+     * "agc_len"; the changes in one message take effect together. A new
+     * template may not be longer than the one the block was made with,
+     * and once the flowgraph runs, a change that needs a bigger FFT
+     * block than its buffers were sized for (say a Doppler bank turned
+     * on after starting with the direct-form correlator) is refused.
+     *
      */
-    class AIS_API corr_est_cc : virtual public sync_block
+    template <class T>
+    class AIS_API corr_est : virtual public sync_block
     {
     public:
-      typedef boost::shared_ptr<corr_est_cc> sptr;
+      typedef boost::shared_ptr<corr_est<T> > sptr;
 
       /*!
        * Make a block that correlates against the \p symbols vector
@@ -97,15 +225,85 @@ namespace gr {
        * \param mark_delay tag marking delay in samples after the
        *                   corr_start tag
        * \param threshold  Threshold of correlator, relative to a 100%
-       *                   correlation (1.0). Default is 0.9.
+       *                   correlation (1.0). Default is 0.9. In CFAR
+       *                   mode, the per-sample false-alarm probability.
+       * \param threshold_method Absolute or CFAR threshold.
+       * \param engine     Correlator implementation to use.
+       * \param max_latency With CORR_ENGINE_AUTO, the largest block of
+       *                   samples (0 for no limit) the correlator may
+       *                   wait for before producing output.
        */
       static sptr make(const std::vector<gr_complex> &symbols,
-                       float sps, unsigned int mark_delay, float threshold=0.9);
+                       float sps, unsigned int mark_delay, float threshold=0.9,
+                       tm_type threshold_method=THRESHOLD_ABSOLUTE,
+                       corr_engine_type engine=CORR_ENGINE_AUTO,
+                       unsigned int max_latency=0);
 
+      //! The template as given, not time-reversed or conjugated
       virtual std::vector<gr_complex> symbols() const = 0;
+      //! Replace the template; it may not be longer than the one given to make()
       virtual void set_symbols(const std::vector<gr_complex> &symbols) = 0;
+
+      //! The correlator implementation in use (never CORR_ENGINE_AUTO)
+      virtual corr_engine_type engine() const = 0;
+
+      //! Choose tags, a single record tag or batched messages
+      virtual void set_detection_format(det_format_type format) = 0;
+      virtual det_format_type detection_format() const = 0;
+
+      //! Fraction of the CFAR threshold the output must drop below to re-arm
+      virtual void set_hysteresis(float hysteresis) = 0;
+      virtual float hysteresis() const = 0;
+
+      /*!
+       * Tag each detection with freq_est (and freq_bin with a Doppler
+       * bank). Off by default, as each estimate costs a pass over the
+       * template; records always carry it.
+       */
+      virtual void set_freq_estimate(bool enable) = 0;
+      virtual bool freq_estimate() const = 0;
+
+      /*!
+       * Change the threshold, in the units given to make(): relative to
+       * a 100% correlation, or the false-alarm probability in CFAR mode.
+       */
+      virtual void set_threshold(float threshold) = 0;
+      //! Detection threshold in use, in correlator output power
+      virtual float threshold() const = 0;
+      //! Running estimate of the correlator output noise power (CFAR only)
+      virtual float noise_floor() const = 0;
+      //! Number of detections tagged so far
+      virtual uint64_t detections() const = 0;
+      /*!
+       * Number of times the correlation crossed the threshold again
+       * before falling below the re-arm level, and so was not tagged
+       */
+      virtual uint64_t rearm_crossings() const = 0;
+
+      /*!
+       * Search carrier offsets up to +/- \p max_offset radians per sample
+       * with a bank of frequency-shifted correlators. 0 (the default)
+       * turns the bank off and returns to the configured engine.
+       */
+      virtual void set_doppler_bank(float max_offset) = 0;
+      //! Number of frequency hypotheses searched, 1 without a bank
+      virtual int doppler_bins() const = 0;
+      //! Spacing between hypotheses, in radians per sample
+      virtual float doppler_spacing() const = 0;
+
+      /*!
+       * Scale the \p burst_len pass-through samples from each detection
+       * to amplitude \p reference, using the correlation peak's amplitude
+       * estimate. A reference of 0 (the default) leaves the output as is.
+       * corr_est_sc16 saturates, so keep its reference below 1.
+       */
+      virtual void set_burst_agc(float reference, int burst_len) = 0;
+      virtual float burst_agc_reference() const = 0;
     };
 
+    typedef corr_est<gr_complex> corr_est_cc;
+    typedef corr_est<lv_16sc_t> corr_est_sc16;
+
   } // namespace digital
 } // namespace gr
 
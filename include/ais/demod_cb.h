@@ -0,0 +1,114 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIS_DEMOD_CB_H
+#define INCLUDED_AIS_DEMOD_CB_H
+
+#include <ais/api.h>
+#include <ais/corr_est_cc.h>
+#include <gnuradio/block.h>
+
+namespace gr {
+  namespace ais {
+
+    /*!
+     * \brief Complete AIS GMSK demodulator, baseband samples in, bits out
+     * \ingroup ais
+     *
+     * \details
+     * Does the work of the feedforward_agc_cc -> corr_est_cc ->
+     * msk_timing_recovery_cc -> quadrature_demod_cf -> binary_slicer_fb ->
+     * diff_decoder_bb -> invert chain in a single block, passing samples
+     * between the stages in small internal buffers instead of through the
+     * scheduler. Each stage does the same arithmetic in the same order as
+     * the block it replaces; the timing loop shares its interpolator with
+     * msk_timing_recovery_cc, and the build keeps the compiler from
+     * fusing multiply-adds in either. The output bits are meant to be
+     * those of the chain, but this has been checked only on simulated
+     * bursts, so ais_demod still uses the chain by default.
+     *
+     * The input should already be frequency corrected (see
+     * square_and_fft_sync_cc). The output is one unpacked, NRZI-decoded
+     * bit per byte, ready for HDLC deframing.
+     */
+    class AIS_API demod_cb : virtual public gr::block
+    {
+     public:
+      typedef boost::shared_ptr<demod_cb> sptr;
+
+      /*!
+       * \brief Make an AIS demodulator.
+       *
+       * \param symbols: Modulated preamble to correlate against
+       * \param sps: Samples per symbol
+       * \param mark_delay: Preamble symbol to mark the timing estimate at
+       * \param threshold: Fraction of the preamble autocorrelation peak
+       *                   to detect on (try 0.9)
+       * \param gain: Timing loop gain
+       * \param limit: Relative limit of timing error
+       * \param agc_len: AGC window length in samples
+       * \param agc_reference: AGC output envelope
+       * \param engine: Correlator implementation (see corr_est_cc)
+       * \param max_latency: Latency budget for CORR_ENGINE_AUTO
+       */
+      static sptr make(const std::vector<gr_complex> &symbols,
+                       float sps, unsigned int mark_delay,
+                       float threshold, float gain, float limit,
+                       int agc_len=512, float agc_reference=2.0,
+                       corr_engine_type engine=CORR_ENGINE_AUTO,
+                       unsigned int max_latency=0);
+
+      virtual void set_gain(float gain)=0;
+      virtual float get_gain(void)=0;
+
+      virtual void set_limit(float limit)=0;
+      virtual float get_limit(void)=0;
+
+      /*!
+       * \brief Gear-shift the loop gain after each preamble.
+       *
+       * For \p nsymbols symbols after each preamble the loop runs at
+       * \p gain, then drops back to the tracking gain set by set_gain().
+       * A high acquisition gain lets the loop pull in within the preamble
+       * at low samples per symbol. \p nsymbols = 0 turns this off.
+       */
+      virtual void set_acquisition(float gain, int nsymbols)=0;
+      virtual float get_acquisition_gain(void)=0;
+      virtual int get_acquisition_len(void)=0;
+
+      /*!
+       * \brief Correct each burst by its preamble's frequency estimate.
+       *
+       * As corr_est_cc followed by burst_derotator_cc: the carrier offset
+       * measured over each preamble is removed from the burst that
+       * follows, so no square_and_fft_sync_cc is needed ahead of this
+       * block. Off by default.
+       */
+      virtual void set_freq_correction(bool enable)=0;
+      virtual bool get_freq_correction(void)=0;
+
+      //! Number of preamble detections so far
+      virtual uint64_t detections() const = 0;
+    };
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_AIS_DEMOD_CB_H */
@@ -0,0 +1,92 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef INCLUDED_AIS_ENERGY_SQUELCH_CC_H
+#define INCLUDED_AIS_ENERGY_SQUELCH_CC_H
+
+#include <ais/api.h>
+#include <gnuradio/block.h>
+
+namespace gr {
+  namespace ais {
+
+    /*!
+     * \brief Drop the quiet stretches between bursts
+     * \ingroup ais
+     *
+     * \details
+     * Measures the power of each \p block_len input samples and keeps a
+     * running estimate of the noise floor from the quiet ones dropped
+     * while the squelch is closed; it doesn't move while open, so a
+     * long burst can't raise it and close the squelch early. While the
+     * power stays within \p threshold_db of the floor, input is consumed
+     * and nothing comes out. When a block rises above it the squelch
+     * opens: the \p preroll samples before that block go out first, so
+     * the burst's ramp and preamble aren't lost to the block granularity,
+     * then everything up to \p hangover samples after the power last
+     * exceeded the threshold.
+     *
+     * Everything downstream counts output samples, so stream offsets
+     * (the deframer's "offset" metadata, say) are post-squelch. The first
+     * sample out after a closed stretch carries a "gap" tag holding the
+     * number of input samples dropped just before it, from which input
+     * positions can be recovered. Input tags on samples that pass through
+     * stay on them; those on dropped samples (the preroll included) move
+     * to the first sample out after the gap, keeping only the latest of
+     * each key, so stream tags such as rx_rate and rx_freq survive.
+     *
+     * Put after channel filtering, ahead of frequency sync and
+     * correlation, so that none of those run on empty spectrum. The
+     * hangover should cover the look-ahead of the blocks downstream (an
+     * FFT frame of square_and_fft_sync_cc, the correlator's block), or
+     * the end of each burst waits in their buffers for the next one.
+     */
+    class AIS_API energy_squelch_cc : virtual public gr::block
+    {
+     public:
+      typedef boost::shared_ptr<energy_squelch_cc> sptr;
+
+      /*!
+       * \brief Return a shared_ptr to a new instance of ais::energy_squelch_cc.
+       *
+       * \param block_len Samples per power measurement
+       * \param threshold_db Opening level above the noise floor, in dB
+       * \param preroll Samples before the opening block to pass on
+       * \param hangover Samples to keep passing once the power drops
+       */
+      static sptr make(int block_len, float threshold_db, int preroll,
+                       int hangover);
+
+      virtual void set_threshold(float threshold_db) = 0;
+      virtual float threshold() const = 0;
+
+      //! Noise floor estimate, as mean power per sample
+      virtual float noise_floor() const = 0;
+      //! True while samples are passing
+      virtual bool is_open() const = 0;
+      //! Input samples dropped so far
+      virtual uint64_t dropped() const = 0;
+    };
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_AIS_ENERGY_SQUELCH_CC_H */
@@ -32,6 +32,10 @@ namespace gr {
      * \brief <+description of block+>
      * \ingroup ais
      *
+     * \details
+     * If \p interpolate is set, the peak is refined to a fraction of a
+     * bin by fitting a parabola through it and its neighbours, so a
+     * shorter FFT can be used for the same frequency resolution.
      */
     class AIS_API freqest : virtual public gr::sync_block
     {
@@ -46,7 +50,8 @@ namespace gr {
        * class. ais::freqest::make is the public interface for
        * creating new instances.
        */
-      static sptr make(float sample_rate, int data_rate, int fftlen);
+      static sptr make(float sample_rate, int data_rate, int fftlen,
+                       bool interpolate=false);
     };
 
   } // namespace ais
@@ -0,0 +1,90 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIS_GMSK_VITERBI_CB_H
+#define INCLUDED_AIS_GMSK_VITERBI_CB_H
+
+#include <ais/api.h>
+#include <gnuradio/block.h>
+
+namespace gr {
+  namespace ais {
+
+    /*!
+     * \brief Coherent GMSK detector, a Viterbi search of the modulation's trellis
+     * \ingroup ais
+     *
+     * \details
+     * Takes one complex sample per symbol, as from msk_timing_recovery_cc
+     * with osps 1, and puts out NRZI-decoded bits one to a byte, the same
+     * as quadrature_demod_cf, binary_slicer_fb, diff_decoder_bb and
+     * invert in turn. Rather than slicing the phase change between each
+     * pair of samples, it finds the symbol sequence whose modulated
+     * phase best matches the samples themselves.
+     *
+     * The phase pulse is truncated to three symbols, so a sample depends
+     * on three symbols and on the phase accumulated by all those before,
+     * a multiple of pi/2: 16 states, with two branches each.
+     * \p sample_offset is where the input is sampled, in symbols from the
+     * centre of a symbol's frequency pulse; msk_timing_recovery_cc
+     * settles halfway between two (0.5), where the discriminator's eye
+     * is widest. The branch metric is the correlation of the sample with
+     * the branch's unit phasor, which needs no amplitude estimate.
+     *
+     * Each "phase_est" tag, or "corr_det" record, from corr_est_cc resets
+     * the detector for a new burst: the survivors so far are traced back
+     * and put out, all states start level, and the input is derotated by
+     * the tagged carrier phase. Between resets a decision-directed loop
+     * of gain \p loop_gain follows the residual phase and frequency from
+     * the best state's latest branch. What's left of the pi/2 ambiguity
+     * doesn't matter, since the bits are in the phase changes.
+     *
+     * Survivors are traced back in blocks of \p traceback symbols, so a
+     * bit comes out between \p traceback and 2 * \p traceback symbols
+     * after its sample, or at the next reset. Tags are not propagated.
+     */
+    class AIS_API gmsk_viterbi_cb : virtual public gr::block
+    {
+     public:
+      typedef boost::shared_ptr<gmsk_viterbi_cb> sptr;
+
+      /*!
+       * \brief Return a shared_ptr to a new instance of ais::gmsk_viterbi_cb.
+       *
+       * \param bt Gaussian filter bandwidth-time product
+       * \param sample_offset Sampling instant, in symbols after a pulse centre
+       * \param traceback Survivor depth in symbols before a bit is decided
+       * \param loop_gain Gain of the carrier tracking loop, 0 to hold the
+       *                  tagged phase
+       */
+      static sptr make(float bt=0.4, float sample_offset=0.5,
+                       int traceback=32, float loop_gain=0.05);
+
+      virtual void set_loop_gain(float loop_gain) = 0;
+      virtual float loop_gain() const = 0;
+
+      //! Bursts started so far
+      virtual uint64_t resets() const = 0;
+    };
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_AIS_GMSK_VITERBI_CB_H */
@@ -0,0 +1,98 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIS_HDLC_DEFRAMER_BP_H
+#define INCLUDED_AIS_HDLC_DEFRAMER_BP_H
+
+#include <ais/api.h>
+#include <gnuradio/sync_block.h>
+
+namespace gr {
+  namespace ais {
+
+    /*!
+     * \brief AIS HDLC deframer, packed bits in, PDUs out
+     * \ingroup ais
+     *
+     * \details
+     * Takes the demodulated bit stream packed eight bits to a byte, first
+     * bit in the MSB (as from unpacked_to_packed_bb(1, GR_MSB_FIRST)).
+     * Finds 0x7E flags, removes stuffed bits and checks the CRC-16/X.25
+     * frame check sequence, then posts each good frame as a PDU on the
+     * "out" port. Frame bytes are assembled first-bit-in-LSB, so the PDUs
+     * are the same as those of digital.hdlc_deframer_bp. The PDU metadata
+     * holds the input item in which the closing flag ended as "offset".
+     *
+     * With \p nrzi set the input is the raw slicer output and the block
+     * also does the NRZI decoding (no transition is a one).
+     *
+     * An optional second input takes a confidence (0-255, higher is
+     * surer) for each bit of the first, as one item of 8 bytes per
+     * packed byte: soft_slicer_fb's second output through
+     * stream_to_vector(1, 8). With it and \p flip_bits > 0, a frame that
+     * fails the CRC gets a second chance if no more than \p flip_bits of
+     * its bits have a confidence below \p conf_floor: every combination
+     * of flips of those bits is tried, and the least costly one (by
+     * summed confidence) that makes the CRC check is taken. A frame with
+     * more doubtful bits than that, such as one deframed out of noise,
+     * is dropped as before. Each flip changes the CRC syndrome by a
+     * fixed amount depending only on the bit's position, and the
+     * combinations are visited in Gray code order, so each costs one XOR
+     * and a compare: 2^flip_bits - 1 per failed frame at most. With
+     * \p nrzi, a confidence belongs to a channel bit, and a flip inverts
+     * the two decoded bits that one wrong channel bit affects. Recovered
+     * frames carry "flipped", the number of flips, in their metadata.
+     *
+     * Each combination tried is another chance for a bad frame to pass
+     * by accident, about 2^flip_bits in 65536 per frame that gets that
+     * far, so \p flip_bits is limited to 8.
+     */
+    class AIS_API hdlc_deframer_bp : virtual public gr::sync_block
+    {
+     public:
+      typedef boost::shared_ptr<hdlc_deframer_bp> sptr;
+
+      /*!
+       * \brief Make an AIS HDLC deframer.
+       *
+       * \param length_min: Shortest frame to pass, in bytes, excluding FCS
+       * \param length_max: Longest frame to pass, in bytes, excluding FCS
+       * \param nrzi: NRZI-decode the input first
+       * \param flip_bits: Most doubtful bits to try flipping in a frame
+       *                   that fails the CRC, 0 to 8
+       * \param conf_floor: Confidence below which a bit is doubtful
+       */
+      static sptr make(int length_min=11, int length_max=64, bool nrzi=false,
+                       int flip_bits=0, int conf_floor=16);
+
+      virtual void set_flip_bits(int flip_bits) = 0;
+      virtual int flip_bits() const = 0;
+
+      virtual void set_conf_floor(int conf_floor) = 0;
+      virtual int conf_floor() const = 0;
+
+      //! Frames passed after bit flipping so far
+      virtual uint64_t recovered() const = 0;
+    };
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_AIS_HDLC_DEFRAMER_BP_H */
@@ -0,0 +1,101 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIS_IQ_FILE_SOURCE_H
+#define INCLUDED_AIS_IQ_FILE_SOURCE_H
+
+#include <ais/api.h>
+#include <gnuradio/sync_block.h>
+#include <volk/volk_complex.h>
+
+namespace gr {
+  namespace ais {
+
+    /*!
+     * Sample formats of IQ recordings: interleaved little-endian I/Q as
+     * float32 (what file_source reads), int8 (HackRF), uint8 offset by
+     * 127.5 (RTL-SDR) or int16. IQ_AUTO goes by the file name: .cs8, .cu8,
+     * .cs16, .cf32, or a SigMF recording's own metadata; anything else is
+     * taken as float32.
+     */
+    enum iq_format {
+      IQ_AUTO,
+      IQ_CF32,
+      IQ_CS8,
+      IQ_CU8,
+      IQ_CS16
+    };
+
+    /*!
+     * \brief Memory-mapped IQ recording source
+     * \ingroup ais
+     *
+     * \details
+     * Reads a recording in any of the iq_format formats straight from a
+     * memory map, converting to complex float into the output buffer, so
+     * that 8 and 16 bit captures can be replayed without expanding them
+     * on disk first.
+     *
+     * With \p sc16 the output is interleaved int16 instead, full scale at
+     * 1.0, for the _sc16 blocks: cs16 is copied as it is, cs8 and cu8 are
+     * shifted up to 16 bits, and cf32 is scaled and saturated.
+     *
+     * A SigMF recording is named by its .sigmf-meta or .sigmf-data file,
+     * or the common base name. The datatype comes from the metadata
+     * (ci8, cu8, ci16_le or cf32_le) unless a format is given, and
+     * sample_rate() and center_freq() always do; they are also tagged on
+     * the first output item as rx_rate and rx_freq.
+     */
+    class AIS_API iq_file_source : virtual public gr::sync_block
+    {
+     public:
+      typedef boost::shared_ptr<iq_file_source> sptr;
+
+      /*!
+       * \brief Open a recording.
+       *
+       * \param filename: Recording to read
+       * \param format: Sample format, or IQ_AUTO
+       * \param repeat: Start over at the end
+       * \param offset: Samples to skip at the start
+       * \param len: Samples to read after that, or 0 for the rest
+       * \param sc16: Output lv_16sc_t rather than gr_complex
+       */
+      static sptr make(const std::string &filename, iq_format format=IQ_AUTO,
+                       bool repeat=false, uint64_t offset=0, uint64_t len=0,
+                       bool sc16=false);
+
+      //! Sample format in use, never IQ_AUTO
+      virtual iq_format format() const = 0;
+
+      //! Samples in the whole file
+      virtual uint64_t nitems() const = 0;
+
+      //! Sample rate from SigMF metadata, or 0 if not known
+      virtual double sample_rate() const = 0;
+
+      //! Centre frequency from SigMF metadata, or 0 if not known
+      virtual double center_freq() const = 0;
+    };
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_AIS_IQ_FILE_SOURCE_H */
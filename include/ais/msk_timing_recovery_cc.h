@@ -25,10 +25,23 @@
 
 #include <ais/api.h>
 #include <gnuradio/block.h>
+#include <volk/volk_complex.h>
 
 namespace gr {
   namespace ais {
 
+    /*!
+     * Interpolators for the MSK timing loop. INTERP_MMSE is the 8-tap
+     * MMSE polyphase filter of mmse_fir_interpolator_cc. INTERP_CUBIC
+     * (a cubic Lagrange Farrow structure) and INTERP_LINEAR are cheaper,
+     * and lose little at high samples per symbol.
+     */
+    enum interp_type {
+      INTERP_MMSE,
+      INTERP_CUBIC,
+      INTERP_LINEAR
+    };
+
     /*!
      * \brief MSK/GMSK timing recovery
      * \ingroup synchronizers_blk
@@ -42,11 +55,32 @@ namespace gr {
      * A.N. D'Andrea, U. Mengali, R. Reggiannini: A digital approach to clock
      * recovery in generalized minimum shift keying. IEEE Transactions on
      * Vehicular Technology, Vol. 39, Issue 3.
+     *
+     * In burst-gated mode the loop only runs for a window of \p burst_len
+     * symbols following each "time_est" or "corr_det" tag (as produced by
+     * corr_est_cc).
+     * Input outside these windows is consumed without being processed, and
+     * the first and last output items of each window are tagged
+     * "burst_start" and "burst_end" so downstream blocks can idle between
+     * bursts too.
+     *
+     * msk_timing_recovery_sc16 takes and produces interleaved int16
+     * samples, full scale at 1.0. Its interpolator is fixed point and
+     * saturates to int16; the loop itself runs in float, once per half
+     * symbol. As with the float block, the loop gain assumes a levelled
+     * input.
+     *
+     * The setters may be called while the flowgraph runs; the loop picks
+     * up their changes at the start of its next work call without taking
+     * a lock. The same can be sent to the "config" message port as a dict
+     * with any of the keys gain, limit, sps, acq_gain, acq_len,
+     * burst_gated and burst_len.
      */
-    class AIS_API msk_timing_recovery_cc : virtual public gr::block
+    template <class T>
+    class AIS_API msk_timing_recovery : virtual public gr::block
     {
      public:
-      typedef boost::shared_ptr<msk_timing_recovery_cc> sptr;
+      typedef boost::shared_ptr<msk_timing_recovery<T> > sptr;
 
       /*!
        * \brief Make an MSK timing recovery block.
@@ -55,9 +89,12 @@ namespace gr {
        * \param gain: Loop gain of timing error filter (try 0.05)
        * \param limit: Relative limit of timing error (try 0.1 for 10% error max)
        * \param osps: Output samples per symbol
+       * \param burst_gated: Only run the loop over correlator-detected bursts
+       * \param burst_len: Length of the gate window in symbols
        *
        */
-      static sptr make(float sps, float gain, float limit, int osps);
+      static sptr make(float sps, float gain, float limit, int osps,
+                       bool burst_gated=false, int burst_len=292);
 
       virtual void set_gain(float gain)=0;
       virtual float get_gain(void)=0;
@@ -65,10 +102,34 @@ namespace gr {
       virtual void set_limit(float limit)=0;
       virtual float get_limit(void)=0;
 
+      /*!
+       * \brief Gear-shift the loop gain after each timing reset.
+       *
+       * For \p nsymbols symbols after each preamble the loop runs at
+       * \p gain, then drops back to the tracking gain set by set_gain().
+       * A high acquisition gain lets the loop pull in within the preamble
+       * at low samples per symbol. \p nsymbols = 0 turns this off.
+       */
+      virtual void set_acquisition(float gain, int nsymbols)=0;
+      virtual float get_acquisition_gain(void)=0;
+      virtual int get_acquisition_len(void)=0;
+
       virtual void set_sps(float sps)=0;
       virtual float get_sps(void)=0;
+
+      virtual void set_burst_gated(bool burst_gated)=0;
+      virtual bool get_burst_gated(void)=0;
+
+      virtual void set_burst_len(int burst_len)=0;
+      virtual int get_burst_len(void)=0;
+
+      virtual void set_interpolator(interp_type type)=0;
+      virtual interp_type get_interpolator(void)=0;
     };
 
+    typedef msk_timing_recovery<gr_complex> msk_timing_recovery_cc;
+    typedef msk_timing_recovery<lv_16sc_t> msk_timing_recovery_sc16;
+
   } // namespace digital
 } // namespace gr
 
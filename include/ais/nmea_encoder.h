@@ -0,0 +1,76 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIS_NMEA_ENCODER_H
+#define INCLUDED_AIS_NMEA_ENCODER_H
+
+#include <ais/api.h>
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+
+namespace gr {
+  namespace ais {
+
+    /*!
+     * \brief Formats AIS frames as !AIVDM sentences into caller buffers
+     * \ingroup ais
+     *
+     * \details
+     * The sentences are those pdu_to_nmea produces: the payload is armored
+     * three bytes to four characters at a time, long payloads are split
+     * over several sentences separated by '\n', and each gets its NMEA
+     * 0183 checksum. Nothing is allocated per call; the caller supplies
+     * the output buffer, sized with max_length().
+     */
+    class AIS_API nmea_encoder
+    {
+     public:
+      nmea_encoder(const std::string &designator);
+
+      //! Most characters encode() can write for a \p len byte frame
+      size_t max_length(size_t len) const;
+
+      /*!
+       * \brief Format one frame.
+       *
+       * Returns the number of characters written (no terminating newline
+       * or NUL), or 0 if \p size is less than max_length(len).
+       */
+      size_t encode(const uint8_t *data, size_t len, char *buf, size_t size) const;
+
+      /*!
+       * \brief Format a batch of frames, each followed by '\n'.
+       *
+       * Stops early at the first frame which doesn't fit in what's left
+       * of \p buf. Returns the number of frames formatted; the number of
+       * characters written goes in \p nwritten.
+       */
+      size_t encode(const uint8_t *const *data, const size_t *len, size_t n,
+                    char *buf, size_t size, size_t &nwritten) const;
+
+     private:
+      std::string d_designator;
+    };
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_AIS_NMEA_ENCODER_H */
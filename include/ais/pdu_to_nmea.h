@@ -29,9 +29,14 @@ namespace gr {
   namespace ais {
 
     /*!
-     * \brief <+description of block+>
+     * \brief Formats AIS frame PDUs as !AIVDM sentences
      * \ingroup ais
      *
+     * \details
+     * Messages on "print" are written to stdout; messages on "to_nmea"
+     * are posted on "out" as PDUs of sentence text. Either port also
+     * takes a PMT vector of frame PDUs and formats the whole batch in one
+     * go, one sentence per line. See nmea_encoder for the formatting.
      */
     class AIS_API pdu_to_nmea : virtual public gr::block
     {
@@ -0,0 +1,67 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIS_SOFT_SLICER_FB_H
+#define INCLUDED_AIS_SOFT_SLICER_FB_H
+
+#include <ais/api.h>
+#include <gnuradio/sync_block.h>
+
+namespace gr {
+  namespace ais {
+
+    /*!
+     * \brief Binary slicer with a confidence for each bit
+     * \ingroup ais
+     *
+     * \details
+     * Slices like digital.binary_slicer_fb (1 for a nonnegative input)
+     * and, on an optional second output, gives each bit a confidence:
+     * its log-likelihood ratio if the input is the symbol amplitude plus
+     * Gaussian noise, in quarter nats, saturated at 255. The amplitude
+     * and the noise variance are running estimates from the mean of |x|
+     * and of x^2, with a time constant of 1/\p alpha bits.
+     *
+     * Meant for the discriminator output, ahead of hdlc_deframer_bp's
+     * bit-flip recovery, which only uses the confidences to rank the bits
+     * of a frame against each other.
+     */
+    class AIS_API soft_slicer_fb : virtual public gr::sync_block
+    {
+     public:
+      typedef boost::shared_ptr<soft_slicer_fb> sptr;
+
+      /*!
+       * \brief Return a shared_ptr to a new instance of ais::soft_slicer_fb.
+       *
+       * \param alpha Averaging constant of the amplitude and noise estimates
+       */
+      static sptr make(float alpha=0.02);
+
+      //! Running estimate of the symbol amplitude
+      virtual float amplitude() const = 0;
+      //! Running estimate of the noise variance about it
+      virtual float noise_variance() const = 0;
+    };
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_AIS_SOFT_SLICER_FB_H */
@@ -0,0 +1,69 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef INCLUDED_AIS_SQUARE_AND_FFT_SYNC_CC_H
+#define INCLUDED_AIS_SQUARE_AND_FFT_SYNC_CC_H
+
+#include <ais/api.h>
+#include <gnuradio/sync_block.h>
+
+namespace gr {
+  namespace ais {
+
+    /*!
+     * \brief Square-and-FFT frequency correction for MSK/GMSK
+     * \ingroup ais
+     *
+     * \details
+     * Squares the input, takes an FFT of each \p fftlen samples and looks
+     * for the pair of tones \p data_rate apart that squared MSK produces
+     * (see ais::freqest). The estimate is held as block state and the same
+     * \p fftlen samples are derotated by it with an NCO.
+     *
+     * This is a single-block equivalent of the Python
+     * gmsk_sync.square_and_fft_sync_cc hier block, and produces the same
+     * frequency estimates.
+     */
+    class AIS_API square_and_fft_sync_cc : virtual public gr::sync_block
+    {
+     public:
+      typedef boost::shared_ptr<square_and_fft_sync_cc> sptr;
+
+      /*!
+       * \brief Return a shared_ptr to a new instance of ais::square_and_fft_sync_cc.
+       *
+       * \param sample_rate Input sample rate
+       * \param data_rate Symbol rate of the signal (9600 for AIS)
+       * \param fftlen Length of FFT used for each estimate
+       * \param interpolate Refine the peak to a fraction of an FFT bin
+       */
+      static sptr make(float sample_rate, int data_rate, int fftlen,
+                       bool interpolate=false);
+
+      //! Most recent frequency estimate in Hz
+      virtual float freq() const = 0;
+    };
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_AIS_SQUARE_AND_FFT_SYNC_CC_H */
+
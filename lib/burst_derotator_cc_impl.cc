@@ -0,0 +1,120 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+#include <gnuradio/expj.h>
+#include "burst_derotator_cc_impl.h"
+#include <ais/corr_detection.h>
+#include <volk/volk.h>
+#include <algorithm>
+
+namespace gr {
+  namespace ais {
+
+    burst_derotator_cc::sptr
+    burst_derotator_cc::make(int burst_len)
+    {
+      return gnuradio::get_initial_sptr
+        (new burst_derotator_cc_impl(burst_len));
+    }
+
+    burst_derotator_cc_impl::burst_derotator_cc_impl(int burst_len)
+      : gr::sync_block("burst_derotator_cc",
+                       gr::io_signature::make(1, 1, sizeof(gr_complex)),
+                       gr::io_signature::make(1, 1, sizeof(gr_complex))),
+        d_remaining(0),
+        d_freq(0),
+        d_phase_inc(1),
+        d_phase(1),
+        d_freq_est_key(pmt::intern("freq_est")),
+        d_corr_det_key(pmt::intern("corr_det"))
+    {
+      set_burst_len(burst_len);
+    }
+
+    burst_derotator_cc_impl::~burst_derotator_cc_impl()
+    {
+    }
+
+    void
+    burst_derotator_cc_impl::set_burst_len(int burst_len)
+    {
+      if(burst_len <= 0) throw std::out_of_range("Burst length must be positive");
+      d_burst_len = burst_len;
+    }
+
+    // Derotate what's left of the current burst, and copy the rest
+    void
+    burst_derotator_cc_impl::rotate(const gr_complex *in, gr_complex *out,
+                                    int nitems)
+    {
+      int n = std::min(nitems, d_remaining);
+      if(n > 0)
+        volk_32fc_s32fc_x2_rotator_32fc(out, in, d_phase_inc, &d_phase, n);
+      if(nitems > n)
+        memcpy(out + n, in + n, sizeof(gr_complex)*(nitems - n));
+      d_remaining -= n;
+    }
+
+    int
+    burst_derotator_cc_impl::work(int noutput_items,
+                                  gr_vector_const_void_star &input_items,
+                                  gr_vector_void_star &output_items)
+    {
+      const gr_complex *in = (const gr_complex *) input_items[0];
+      gr_complex *out = (gr_complex *) output_items[0];
+
+      const uint64_t base = nitems_read(0);
+      get_tags_in_range(d_tags, 0, base, base + noutput_items);
+      std::sort(d_tags.begin(), d_tags.end(), tag_t::offset_compare);
+
+      int i = 0;
+      for(size_t t = 0; t < d_tags.size(); t++) {
+        float freq;
+        corr_detection det;
+        if(pmt::eq(d_tags[t].key, d_freq_est_key))
+          freq = (float) pmt::to_double(d_tags[t].value);
+        else if(pmt::eq(d_tags[t].key, d_corr_det_key)
+                && corr_detection_from_pmt(d_tags[t].value, det))
+          freq = det.freq_est;
+        else
+          continue;
+        if(freq != freq) //NaN
+          continue;
+
+        int offset = d_tags[t].offset - base;
+        rotate(in + i, out + i, offset - i);
+        i = offset;
+
+        d_freq = freq;
+        d_phase_inc = gr_expj(-freq);
+        d_remaining = d_burst_len;
+      }
+      rotate(in + i, out + i, noutput_items - i);
+
+      return noutput_items;
+    }
+
+  } /* namespace ais */
+} /* namespace gr */
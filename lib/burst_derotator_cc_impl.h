@@ -0,0 +1,59 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIS_BURST_DEROTATOR_CC_IMPL_H
+#define INCLUDED_AIS_BURST_DEROTATOR_CC_IMPL_H
+
+#include <ais/burst_derotator_cc.h>
+
+namespace gr {
+  namespace ais {
+
+    class burst_derotator_cc_impl : public burst_derotator_cc
+    {
+     private:
+      int d_burst_len;
+      int d_remaining;
+      float d_freq;
+      gr_complex d_phase_inc;
+      gr_complex d_phase;
+      std::vector<tag_t> d_tags;
+      const pmt::pmt_t d_freq_est_key;
+      const pmt::pmt_t d_corr_det_key;
+
+      void rotate(const gr_complex *in, gr_complex *out, int nitems);
+
+     public:
+      burst_derotator_cc_impl(int burst_len);
+      ~burst_derotator_cc_impl();
+
+      void set_burst_len(int burst_len);
+      int burst_len() const { return d_burst_len; }
+      float freq() const { return d_freq; }
+
+      int work(int noutput_items,
+               gr_vector_const_void_star &input_items,
+               gr_vector_void_star &output_items);
+    };
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_AIS_BURST_DEROTATOR_CC_IMPL_H */
@@ -0,0 +1,192 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+#include <gnuradio/filter/firdes.h>
+#include "channelizer_ccf_impl.h"
+#include <volk/volk.h>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace gr {
+  namespace ais {
+
+    channelizer_ccf::sptr
+    channelizer_ccf::make(double samp_rate, const std::vector<float> &freqs,
+                          double out_rate, double spacing)
+    {
+      return gnuradio::get_initial_sptr
+        (new channelizer_ccf_impl(samp_rate, freqs, out_rate, spacing));
+    }
+
+    channelizer_ccf_impl::channelizer_ccf_impl(double samp_rate,
+                                               const std::vector<float> &freqs,
+                                               double out_rate, double spacing)
+      : gr::block("channelizer_ccf",
+                  io_signature::make(1, 1, sizeof(gr_complex)),
+                  io_signature::make(freqs.size(), freqs.size(), sizeof(gr_complex)))
+    {
+      if(freqs.empty())
+        throw std::invalid_argument("Need at least one channel");
+      if(out_rate <= 0 || out_rate > samp_rate)
+        throw std::out_of_range("Output rate must be in (0, samp_rate]");
+
+      d_nbranches = (int) round(samp_rate / spacing);
+      if(d_nbranches < 1 || fabs(d_nbranches*spacing - samp_rate) > 1e-3*spacing)
+        throw std::invalid_argument("Sample rate must be a multiple of the channel spacing");
+
+      // Decimate as far as we can without dropping below the output rate,
+      // and let the resamplers make up the (small) difference.
+      d_decim = std::max(1, (int) floor(samp_rate / out_rate));
+      double dec_rate = samp_rate / d_decim;
+      d_rate = out_rate / dec_rate;
+
+      // Same channel filter ais_rx used ahead of the demodulator
+      d_taps = filter::firdes::low_pass(1, samp_rate, 11000, 1000);
+      d_ntaps_per = (d_taps.size() + d_nbranches - 1) / d_nbranches;
+      std::vector<float> h(d_taps);
+      h.resize(d_ntaps_per*d_nbranches, 0);
+      d_branch_taps.resize(2*h.size());
+      for(int q = 0; q < d_ntaps_per; q++) {
+        for(int m = 0; m < d_nbranches; m++) {
+          float t = h[q*d_nbranches + d_nbranches-1 - m];
+          d_branch_taps[2*(q*d_nbranches + m)] = t;
+          d_branch_taps[2*(q*d_nbranches + m) + 1] = t;
+        }
+      }
+      d_branch_out.resize(d_nbranches);
+
+      d_rotation.resize(d_nbranches);
+      for(int i = 0; i < d_nbranches; i++)
+        d_rotation[i] = std::polar(1.0f, float(-2*M_PI*i/d_nbranches));
+
+      // Arbitrary resampler filter, as pfb.arb_resampler_ccf designs it:
+      // a lowpass over the output band at nfilts times the input rate.
+      const int nfilts = 32;
+      std::vector<float> rs_taps =
+        filter::firdes::low_pass(nfilts, nfilts*dec_rate,
+                                 0.4*out_rate, 0.2*out_rate);
+
+      for(size_t c = 0; c < freqs.size(); c++) {
+        int k = (int) round(freqs[c] / spacing);
+        if(fabs(k*spacing - freqs[c]) > 1e-3*spacing
+           || fabs(freqs[c]) >= samp_rate/2)
+          throw std::invalid_argument("Channel " + std::to_string(freqs[c])
+                                      + " Hz is not on the channel grid");
+        k = ((k % d_nbranches) + d_nbranches) % d_nbranches;
+
+        std::vector<gr_complex> w(d_nbranches);
+        for(int m = 0; m < d_nbranches; m++)
+          w[m] = d_rotation[(d_nbranches - (k*(d_nbranches-1 - m)) % d_nbranches) % d_nbranches];
+        d_weights.push_back(w);
+        d_rot_idx.push_back(0);
+        d_rot_step.push_back((k*d_decim) % d_nbranches);
+
+        d_resamplers.push_back(new filter::kernel::pfb_arb_resampler_ccf(d_rate, rs_taps, nfilts));
+        // the resampler reads taps_per_filter samples ahead; start it off
+        // with zeros there, like a block's history
+        d_dec.push_back(std::vector<gr_complex>(d_resamplers.back()->taps_per_filter() - 1, 0));
+      }
+
+      set_history(d_ntaps_per*d_nbranches);
+      set_relative_rate(out_rate / samp_rate);
+      set_min_noutput_items(4);
+    }
+
+    channelizer_ccf_impl::~channelizer_ccf_impl()
+    {
+      for(size_t c = 0; c < d_resamplers.size(); c++)
+        delete d_resamplers[c];
+    }
+
+    void
+    channelizer_ccf_impl::forecast(int noutput_items,
+                                   gr_vector_int &ninput_items_required)
+    {
+      ninput_items_required[0] = (int) ceil(noutput_items / d_rate) * d_decim;
+    }
+
+    int
+    channelizer_ccf_impl::general_work(int noutput_items,
+                                       gr_vector_int &ninput_items,
+                                       gr_vector_const_void_star &input_items,
+                                       gr_vector_void_star &output_items)
+    {
+      const gr_complex *in = (const gr_complex *) input_items[0];
+      const int M = d_nbranches;
+      const int hist = d_ntaps_per*M - 1;
+      const int tpf = d_resamplers[0]->taps_per_filter();
+
+      // Decimated samples to make, limited by the input and by how many
+      // resampled outputs there is room for.
+      int ndec = (ninput_items[0] - hist) / d_decim;
+      int pending = d_dec[0].size() - (tpf - 1);
+      int room = (int) floor((noutput_items - 2) / d_rate) - pending;
+      ndec = std::max(0, std::min(ndec, room));
+
+      for(int n = 0; n < ndec; n++) {
+        // Branch sums, shared by all the channels
+        const int s = hist + n*d_decim;
+        float *acc = (float *) &d_branch_out[0];
+        std::fill(acc, acc + 2*M, 0.0f);
+        for(int q = 0; q < d_ntaps_per; q++) {
+          const float *g = &d_branch_taps[2*q*M];
+          const float *x = (const float *) &in[s - (q+1)*M + 1];
+          for(int k = 0; k < 2*M; k++)
+            acc[k] += g[k]*x[k];
+        }
+
+        // then each channel's DFT bin and rotation
+        for(size_t c = 0; c < d_dec.size(); c++) {
+          gr_complex y;
+          volk_32fc_x2_dot_prod_32fc(&y, &d_branch_out[0], &d_weights[c][0], M);
+          d_dec[c].push_back(y*d_rotation[d_rot_idx[c]]);
+          d_rot_idx[c] += d_rot_step[c];
+          if(d_rot_idx[c] >= M) d_rot_idx[c] -= M;
+        }
+      }
+
+      // Resample each channel to the output rate. The resamplers all see
+      // the same number of samples at the same rate, so they all produce
+      // the same number of outputs.
+      int nout = 0;
+      for(size_t c = 0; c < d_dec.size(); c++) {
+        int n_to_read = d_dec[c].size() - (tpf - 1);
+        int n_read = 0;
+        nout = 0;
+        if(n_to_read > 0) {
+          nout = d_resamplers[c]->filter((gr_complex *) output_items[c],
+                                         &d_dec[c][0], n_to_read, n_read);
+          d_dec[c].erase(d_dec[c].begin(),
+                         d_dec[c].begin() + std::min<size_t>(n_read, d_dec[c].size()));
+        }
+      }
+
+      consume_each(ndec*d_decim);
+      return nout;
+    }
+
+  } /* namespace ais */
+} /* namespace gr */
@@ -0,0 +1,73 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIS_CHANNELIZER_CCF_IMPL_H
+#define INCLUDED_AIS_CHANNELIZER_CCF_IMPL_H
+
+#include <ais/channelizer_ccf.h>
+#include <gnuradio/filter/pfb_arb_resampler.h>
+
+namespace gr {
+  namespace ais {
+
+    class channelizer_ccf_impl : public channelizer_ccf
+    {
+     private:
+      int d_nbranches;            // M, points on the channel grid
+      int d_decim;                // D
+      int d_ntaps_per;            // prototype taps per branch
+      std::vector<float> d_taps;  // prototype as designed
+      // Prototype rearranged so each branch sum runs over contiguous
+      // input: block q holds h[qM + M-1-m] for m = 0..M-1, each tap
+      // twice to line up with the real and imaginary parts.
+      std::vector<float> d_branch_taps;
+      std::vector<gr_complex> d_branch_out;
+
+      // per channel: DFT bin weights, and the output rotation by
+      // exp(-j*2*pi*k*n*D/M) as an index into d_rotation
+      std::vector<std::vector<gr_complex> > d_weights;
+      std::vector<gr_complex> d_rotation;
+      std::vector<int> d_rot_idx;
+      std::vector<int> d_rot_step;
+
+      float d_rate;               // resampler rate
+      std::vector<filter::kernel::pfb_arb_resampler_ccf *> d_resamplers;
+      std::vector<std::vector<gr_complex> > d_dec;
+
+     public:
+      channelizer_ccf_impl(double samp_rate, const std::vector<float> &freqs,
+                           double out_rate, double spacing);
+      ~channelizer_ccf_impl();
+
+      std::vector<float> taps() const { return d_taps; }
+      int decimation() const { return d_decim; }
+
+      void forecast(int noutput_items, gr_vector_int &ninput_items_required);
+
+      int general_work(int noutput_items,
+                       gr_vector_int &ninput_items,
+                       gr_vector_const_void_star &input_items,
+                       gr_vector_void_star &output_items);
+    };
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_AIS_CHANNELIZER_CCF_IMPL_H */
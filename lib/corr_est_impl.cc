@@ -0,0 +1,1209 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2015 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+#include <gnuradio/block_detail.h>
+#include <gnuradio/buffer.h>
+#include <gnuradio/math.h>
+#include <gnuradio/expj.h>
+#include "corr_est_impl.h"
+#include <volk/volk.h>
+#include <boost/format.hpp>
+#include <memory>
+#include <algorithm>
+#include <boost/math/special_functions/round.hpp>
+#include <gnuradio/filter/pfb_arb_resampler.h>
+#include <gnuradio/filter/firdes.h>
+
+namespace gr {
+  namespace ais {
+
+    template <class T>
+    typename corr_est<T>::sptr
+    corr_est<T>::make(const std::vector<gr_complex> &symbols,
+                      float sps, unsigned int mark_delay,
+                      float threshold, tm_type threshold_method,
+                      corr_engine_type engine, unsigned int max_latency)
+    {
+      return gnuradio::get_initial_sptr
+        (new corr_est_impl<T>(symbols, sps, mark_delay, threshold,
+                              threshold_method, engine, max_latency));
+    }
+
+    template <class T>
+    corr_est_impl<T>::config::config()
+      : mark_delay(0), threshold_method(THRESHOLD_ABSOLUTE), thresh(0),
+        cfar_k(0), hysteresis(0.5), det_format(DETECT_TAGS), freq_est(false),
+        engine(CORR_ENGINE_DIRECT), filter(NULL), fir(NULL),
+        output_multiple(1), qbits(0), bank_nhyp(1), bank_step(1),
+        bank_size(0), bank_fwd(NULL), bank_inv(NULL), pre_lag(0),
+        pre_thresh(0), bank_floor(1), energy(0),
+        agc_ref(0), agc_len(0)
+    {
+    }
+
+    template <class T>
+    corr_est_impl<T>::config::~config()
+    {
+      delete filter;
+      delete fir;
+      delete bank_fwd;
+      delete bank_inv;
+    }
+
+    template <class T>
+    float
+    corr_est_impl<T>::config::doppler_spacing() const
+    {
+      return bank_size ? 2*M_PI*bank_step/bank_size : 0;
+    }
+
+    template <class T>
+    corr_est_impl<T>::corr_est_impl(const std::vector<gr_complex> &symbols,
+                                    float sps, unsigned int mark_delay,
+                                    float threshold, tm_type threshold_method,
+                                    corr_engine_type engine,
+                                    unsigned int max_latency)
+      : sync_block("corr_est",
+                   io_signature::make(1, 1, sizeof(T)),
+                   io_signature::make2(0, 2, sizeof(T), sizeof(gr_complex))),
+        d_cfg(NULL),
+        d_pending(NULL),
+        d_max_multiple(0),
+        d_max_ntaps(symbols.size()),
+        d_src_id(pmt::intern(this->alias())),
+        d_noise(0),
+        d_noise_seen(0),
+        d_last_mag(0),
+        d_armed(true),
+        d_held(false),
+        d_detections(0),
+        d_rearm_crossings(0),
+        d_fseg(std::max(1, (int) lrintf(2*sps))),
+        d_pre_noise(0),
+        d_agc_gain(1),
+        d_agc_remaining(0),
+        d_corr(NULL),
+        d_corr_mag(NULL),
+        d_scratch_size(0),
+        d_corr_start_key(pmt::intern("corr_start")),
+        d_phase_est_key(pmt::intern("phase_est")),
+        d_time_est_key(pmt::intern("time_est")),
+        d_corr_est_key(pmt::intern("corr_est")),
+        d_corr_det_key(pmt::intern("corr_det")),
+        d_freq_est_key(pmt::intern("freq_est")),
+        d_freq_bin_key(pmt::intern("freq_bin")),
+        d_amp_est_key(pmt::intern("amp_est")),
+        d_detections_port(pmt::mp("detections")),
+        d_config_port(pmt::mp("config"))
+    {
+      d_sps = sps;
+
+      settings s;
+      s.symbols = symbols;
+      s.mark_delay = mark_delay;
+      s.threshold = threshold;
+      s.threshold_method = threshold_method;
+      s.engine = engine;
+      s.max_latency = max_latency;
+      s.hysteresis = 0.5;
+      s.det_format = DETECT_TAGS;
+      s.freq_est = false;
+      s.bank_max = 0;
+      s.agc_ref = 0;
+      s.agc_len = 0;
+      publish(s);
+      d_cfg = d_pending.exchange(NULL);
+
+      // It looks like the kernel::fft_filter_ccc stashes a tail between
+      // calls, so that contains our filtering history (I think).  The
+      // fft_filter_ccc block (which calls the kernel::fft_filter_ccc) sets
+      // the history to 1 (0 history items), so let's follow its lead.
+      //set_history(1);
+
+      // We'll (ab)use the history for our own purposes of tagging back in time.
+      // Keep a history of the length of the sync word to delay for tagging.
+      // The scheduler can't change it once running, so it stays sized for
+      // this template and set_symbols() can only go shorter.
+      this->set_history(d_max_ntaps+1);
+
+      this->declare_sample_delay(1, 0);
+      this->declare_sample_delay(0, d_max_ntaps);
+
+      // Per comments in gr-filter/include/gnuradio/filter/fft_filter.h,
+      // set the block output multiple to the FFT filter kernel's internal,
+      // assumed "nsamples", to ensure the scheduler always passes a
+      // proper number of samples.
+      this->set_output_multiple(d_cfg->output_multiple);
+
+      // Setting the alignment multiple for volk causes problems with the
+      // expected behavior of setting the output multiple for the FFT filter.
+      // Don't set the alignment multiple.
+      //const int alignment_multiple =
+      //  volk_get_alignment() / sizeof(gr_complex);
+      //set_alignment(std::max(1,alignment_multiple));
+
+      // Scratch space for the correlator output is grown in work() to
+      // whatever the scheduler hands us.
+
+      this->message_port_register_out(d_detections_port);
+      this->message_port_register_in(d_config_port);
+      this->set_msg_handler(d_config_port,
+                            boost::bind(&corr_est_impl<T>::handle_config,
+                                        this, _1));
+      d_batch.reserve(64);
+    }
+
+    template <class T>
+    corr_est_impl<T>::~corr_est_impl()
+    {
+      delete d_cfg;
+      delete d_pending.exchange(NULL);
+      volk_free(d_corr);
+      volk_free(d_corr_mag);
+    }
+
+    // Build a complete configuration from s. Runs in the caller's thread
+    // with whatever allocation and FFT planning it takes, so none of it
+    // lands in work().
+    template <class T>
+    typename corr_est_impl<T>::config *
+    corr_est_impl<T>::build(const settings &s) const
+    {
+      if(s.symbols.empty())
+        throw std::invalid_argument("Correlator template is empty");
+      if(d_max_ntaps > 0 && s.symbols.size() > d_max_ntaps)
+        throw std::invalid_argument("Correlator template can't grow past "
+                                    "the length it was made with");
+
+      std::unique_ptr<config> c(new config);
+
+      // Create time-reversed conjugate of symbols
+      c->symbols = s.symbols;
+      for(size_t i=0; i < c->symbols.size(); i++) {
+          c->symbols[i] = conj(c->symbols[i]);
+      }
+      std::reverse(c->symbols.begin(), c->symbols.end());
+      const unsigned int ntaps = c->symbols.size();
+
+      c->mark_delay = s.mark_delay >= ntaps ? ntaps - 1 : s.mark_delay;
+
+      // Compute a correlation threshold.
+      // Compute the value of the discrete autocorrelation of the matched
+      // filter with offset 0 (aka the autocorrelation peak). A burst of
+      // amplitude A peaks at A times this, the template's energy.
+      for(unsigned int j = 0; j < ntaps; j++)
+        c->energy += std::norm(c->symbols[j]);
+      c->thresh = s.threshold*c->energy*c->energy;
+
+      // For CFAR, the threshold is the false-alarm probability per sample.
+      // Noise-only |corr|^2 is exponentially distributed, so P(x > k*mean)
+      // = exp(-k).
+      c->threshold_method = s.threshold_method;
+      if(c->threshold_method == THRESHOLD_CFAR) {
+        if(s.threshold <= 0 || s.threshold >= 1)
+          throw std::out_of_range("CFAR threshold must be a probability in (0, 1)");
+        c->cfar_k = -logf(s.threshold);
+      }
+      c->hysteresis = s.hysteresis;
+      c->det_format = s.det_format;
+      c->freq_est = s.freq_est;
+
+      // Correlation filter. The direct-form filter reads its history
+      // straight out of the input buffer, so any number of samples will
+      // do; the FFT filter wants whole blocks.
+      c->engine = s.engine;
+      if(c->engine == CORR_ENGINE_AUTO)
+        c->engine = choose_engine(ntaps, s.max_latency);
+      if(c->engine == CORR_ENGINE_FFT) {
+        c->filter = new kernel::fft_filter_ccc(1, c->symbols);
+        c->output_multiple = c->filter->set_taps(c->symbols);
+      }
+      else {
+        c->fir = new kernel::fir_filter_ccc(1, c->symbols);
+      }
+
+      // Fixed-point copy of the template for corr_est_sc16's direct form,
+      // in the order the input is read. Each product term
+      // xr*qr - xi*qi is at most 2^15 * (|qr| + |qi|) with full-scale
+      // corner samples (I = Q = -32768), so the int32 sums stay in range
+      // while the quantized taps have sum(|qr| + |qi|) < 2^16. Checked on
+      // the rounded taps, which is what the accumulators see.
+      c->qtaps.resize(2*ntaps);
+      for(c->qbits = 14; ; c->qbits--) {
+        int64_t sum = 0;
+        bool fits = true;
+        for(unsigned int j = 0; j < ntaps; j++) {
+          const gr_complex &t = c->symbols[ntaps-1-j];
+          long qr = lrintf(t.real()*(1 << c->qbits));
+          long qi = lrintf(t.imag()*(1 << c->qbits));
+          fits = fits && labs(qr) <= 32767 && labs(qi) <= 32767;
+          sum += labs(qr) + labs(qi);
+          c->qtaps[2*j]   = (int16_t) qr;
+          c->qtaps[2*j+1] = (int16_t) qi;
+        }
+        if((fits && sum < 65536) || c->qbits == 0)
+          break;
+      }
+
+      if(s.bank_max > 0) {
+        build_bank(*c, s.bank_max);
+        // The prefilter lets through anything within 3 dB of the
+        // threshold amplitude: its peak grows as the amplitude squared.
+        float pre_energy = 0;
+        for(int j = c->pre_lag; j < (int) ntaps; j++)
+          pre_energy += std::norm(c->symbols[j]*c->symbols[j - c->pre_lag]);
+        c->pre_thresh = 0.25f*s.threshold*s.threshold*pre_energy*pre_energy;
+      }
+
+      c->agc_ref = s.agc_ref;
+      c->agc_len = s.agc_len;
+
+      // Once running, the scheduler can only hand over blocks that fit
+      // the buffers it allocated at the start
+      if(d_max_multiple > 0 && c->output_multiple > d_max_multiple)
+        throw std::invalid_argument(
+          boost::str(boost::format("Correlator block of %d items is more "
+                                   "than the %d the buffers allow")
+                     % c->output_multiple % d_max_multiple));
+      return c.release();
+    }
+
+    // Size the Doppler bank for the template and search range.
+    // An FFT of four times the template (rounded up to a power of two)
+    // keeps the block overhead low and gives bins fine enough to space
+    // the hypotheses at about half the template's coherent bandwidth,
+    // 1/(2*ntaps) cycles per sample.
+    template <class T>
+    void
+    corr_est_impl<T>::build_bank(config &c, float max_offset) const
+    {
+      const int ntaps = c.symbols.size();
+      int size = 1;
+      while(size < 4*ntaps)
+        size <<= 1;
+      c.bank_fwd = new fft::fft_complex(size, true);
+      c.bank_inv = new fft::fft_complex(size, false);
+      c.bank_size = size;
+      c.bank_step = std::max(1, (int) lrint(size/(2.0*ntaps)));
+      int reach = (int) ceil(max_offset*size/(2*M_PI)/c.bank_step);
+      reach = std::min(reach, size/(2*c.bank_step));
+      c.bank_nhyp = 2*reach + 1;
+      c.bank_floor = 0;
+      for(int h = 1; h <= c.bank_nhyp; h++)
+        c.bank_floor += 1.0f/h;
+
+      // The template itself is the conjugate of symbols, time-reversed
+      gr_complex *buf = c.bank_fwd->get_inbuf();
+      std::fill(buf, buf + size, gr_complex(0));
+      for(int j = 0; j < ntaps; j++)
+        buf[j] = std::conj(c.symbols[ntaps-1-j]);
+      c.bank_fwd->execute();
+      const gr_complex *spec = c.bank_fwd->get_outbuf();
+      c.bank_tmpl.resize(size);
+      for(int m = 0; m < size; m++)
+        c.bank_tmpl[m] = std::conj(spec[m])/(float) size;
+
+      // The prefilter's template, the lagged product over a segment as
+      // in estimate_freq()
+      c.pre_lag = std::min(d_fseg, ntaps - 1);
+      std::fill(buf, buf + size, gr_complex(0));
+      for(int j = 0; j + c.pre_lag < ntaps; j++)
+        buf[j] = std::conj(c.symbols[ntaps-1-j-c.pre_lag])*c.symbols[ntaps-1-j];
+      c.bank_fwd->execute();
+      c.pre_tmpl.resize(size);
+      for(int m = 0; m < size; m++)
+        c.pre_tmpl[m] = std::conj(spec[m])/(float) size;
+
+      // Each block yields the outputs whose template window doesn't wrap
+      c.output_multiple = size - ntaps + 1;
+    }
+
+    // Build s and hand it to work(). Call with d_cfg_lock held. Anything
+    // published but not yet picked up is superseded; s is complete, so
+    // nothing is lost.
+    template <class T>
+    void
+    corr_est_impl<T>::publish(const settings &s)
+    {
+      config *c = build(s);
+      // Before the start the scheduler has yet to size the buffers, so
+      // it can size them for this
+      if(d_max_multiple == 0)
+        this->set_output_multiple(c->output_multiple);
+      d_req = s;
+      d_built_engine = c->engine;
+      d_built_thresh = c->thresh;
+      d_built_cfar_k = c->cfar_k;
+      d_built_nhyp = c->bank_nhyp;
+      d_built_spacing = c->doppler_spacing();
+      delete d_pending.exchange(c);
+    }
+
+    // The scheduler keeps the input and output buffers at least twice
+    // the block size (plus the history on the input) so it can always
+    // hand one over; once running, a configuration may not need more.
+    template <class T>
+    bool
+    corr_est_impl<T>::start()
+    {
+      block_detail_sptr d = this->detail();
+      int room = d->input(0)->buffer()->bufsize() - (int) this->history();
+      if(d->noutputs() > 0)
+        room = std::min(room, d->output(0)->bufsize());
+      gr::thread::scoped_lock lock(d_cfg_lock);
+      d_max_multiple = std::max(room/2, this->output_multiple());
+      return sync_block::start();
+    }
+
+    // Swap in a configuration published since the last call, as soon as
+    // the scheduler hands over at least one of its blocks. Until then the
+    // current one carries on over a multiple of its own block, which the
+    // scheduler's noutput_items still is, so no call comes back empty.
+    // build() has checked the new block size fits the buffers. Returns
+    // the number of items to produce.
+    template <class T>
+    int
+    corr_est_impl<T>::pick_up_config(int noutput_items)
+    {
+      config *c = d_pending.exchange(NULL);
+      if(c) {
+        if(noutput_items >= c->output_multiple) {
+          // A new template or bank changes what the noise floor is the
+          // floor of; start it over.
+          if(c->symbols != d_cfg->symbols || c->bank_nhyp != d_cfg->bank_nhyp) {
+            d_noise = 0;
+            d_pre_noise = 0;
+            d_held = false;
+          }
+          if(c->agc_ref == 0)
+            d_agc_remaining = 0;
+          if(c->output_multiple != d_cfg->output_multiple)
+            this->set_output_multiple(c->output_multiple);
+          delete d_cfg;
+          d_cfg = c;
+          return noutput_items - noutput_items % c->output_multiple;
+        }
+        this->set_output_multiple(c->output_multiple);
+        config *none = NULL;
+        if(!d_pending.compare_exchange_strong(none, c))
+          delete c;
+      }
+      return noutput_items - noutput_items % d_cfg->output_multiple;
+    }
+
+    template <class T>
+    std::vector<gr_complex>
+    corr_est_impl<T>::symbols() const
+    {
+      gr::thread::scoped_lock lock(d_cfg_lock);
+      return d_req.symbols;
+    }
+
+    template <class T>
+    void
+    corr_est_impl<T>::set_symbols(const std::vector<gr_complex> &symbols)
+    {
+      gr::thread::scoped_lock lock(d_cfg_lock);
+      settings s = d_req;
+      s.symbols = symbols;
+      publish(s);
+    }
+
+    template <class T>
+    corr_engine_type
+    corr_est_impl<T>::engine() const
+    {
+      gr::thread::scoped_lock lock(d_cfg_lock);
+      return d_built_engine;
+    }
+
+    template <class T>
+    void
+    corr_est_impl<T>::set_detection_format(det_format_type format)
+    {
+      gr::thread::scoped_lock lock(d_cfg_lock);
+      settings s = d_req;
+      s.det_format = format;
+      publish(s);
+    }
+
+    template <class T>
+    det_format_type
+    corr_est_impl<T>::detection_format() const
+    {
+      gr::thread::scoped_lock lock(d_cfg_lock);
+      return d_req.det_format;
+    }
+
+    template <class T>
+    void
+    corr_est_impl<T>::set_hysteresis(float hysteresis)
+    {
+      if(hysteresis <= 0 || hysteresis > 1)
+        throw std::out_of_range("Hysteresis must be in (0, 1]");
+      gr::thread::scoped_lock lock(d_cfg_lock);
+      settings s = d_req;
+      s.hysteresis = hysteresis;
+      publish(s);
+    }
+
+    template <class T>
+    float
+    corr_est_impl<T>::hysteresis() const
+    {
+      gr::thread::scoped_lock lock(d_cfg_lock);
+      return d_req.hysteresis;
+    }
+
+    template <class T>
+    void
+    corr_est_impl<T>::set_freq_estimate(bool enable)
+    {
+      gr::thread::scoped_lock lock(d_cfg_lock);
+      settings s = d_req;
+      s.freq_est = enable;
+      publish(s);
+    }
+
+    template <class T>
+    bool
+    corr_est_impl<T>::freq_estimate() const
+    {
+      gr::thread::scoped_lock lock(d_cfg_lock);
+      return d_req.freq_est;
+    }
+
+    template <class T>
+    void
+    corr_est_impl<T>::set_threshold(float threshold)
+    {
+      gr::thread::scoped_lock lock(d_cfg_lock);
+      settings s = d_req;
+      s.threshold = threshold;
+      publish(s);
+    }
+
+    template <class T>
+    float
+    corr_est_impl<T>::threshold() const
+    {
+      gr::thread::scoped_lock lock(d_cfg_lock);
+      if(d_req.threshold_method == THRESHOLD_CFAR)
+        return d_built_cfar_k*d_noise_seen;
+      return d_built_thresh;
+    }
+
+    template <class T>
+    void
+    corr_est_impl<T>::set_doppler_bank(float max_offset)
+    {
+      if(max_offset < 0 || max_offset >= M_PI)
+        throw std::out_of_range("Doppler search range must be in [0, pi)");
+      gr::thread::scoped_lock lock(d_cfg_lock);
+      settings s = d_req;
+      s.bank_max = max_offset;
+      publish(s);
+    }
+
+    template <class T>
+    int
+    corr_est_impl<T>::doppler_bins() const
+    {
+      gr::thread::scoped_lock lock(d_cfg_lock);
+      return d_built_nhyp;
+    }
+
+    template <class T>
+    float
+    corr_est_impl<T>::doppler_spacing() const
+    {
+      gr::thread::scoped_lock lock(d_cfg_lock);
+      return d_built_spacing;
+    }
+
+    template <class T>
+    void
+    corr_est_impl<T>::set_burst_agc(float reference, int burst_len)
+    {
+      if(reference < 0)
+        throw std::out_of_range("AGC reference must be nonnegative");
+      if(reference > 0 && burst_len <= 0)
+        throw std::out_of_range("Burst length must be positive");
+      gr::thread::scoped_lock lock(d_cfg_lock);
+      settings s = d_req;
+      s.agc_ref = reference;
+      s.agc_len = burst_len;
+      publish(s);
+    }
+
+    template <class T>
+    float
+    corr_est_impl<T>::burst_agc_reference() const
+    {
+      gr::thread::scoped_lock lock(d_cfg_lock);
+      return d_req.agc_ref;
+    }
+
+    // "config" messages: a dict of any of "symbols" (c32vector),
+    // "threshold", "hysteresis", "freq_est" (bool), "doppler" (radians
+    // per sample), "agc_reference" and "agc_len", or a single
+    // (key . value) pair.
+    // Everything in one message is published together.
+    template <class T>
+    void
+    corr_est_impl<T>::handle_config(pmt::pmt_t msg)
+    {
+      if(pmt::is_pair(msg) && pmt::is_symbol(pmt::car(msg)))
+        msg = pmt::dict_add(pmt::make_dict(), pmt::car(msg), pmt::cdr(msg));
+      if(!pmt::is_dict(msg)) {
+        GR_LOG_WARN(this->d_logger, "config message is not a dict; ignored");
+        return;
+      }
+
+      gr::thread::scoped_lock lock(d_cfg_lock);
+      settings s = d_req;
+      try {
+        pmt::pmt_t v;
+        if(!pmt::is_null(v = pmt::dict_ref(msg, pmt::mp("symbols"), pmt::PMT_NIL)))
+          s.symbols = pmt::c32vector_elements(v);
+        if(!pmt::is_null(v = pmt::dict_ref(msg, pmt::mp("threshold"), pmt::PMT_NIL)))
+          s.threshold = pmt::to_double(v);
+        if(!pmt::is_null(v = pmt::dict_ref(msg, pmt::mp("hysteresis"), pmt::PMT_NIL))) {
+          s.hysteresis = pmt::to_double(v);
+          if(s.hysteresis <= 0 || s.hysteresis > 1)
+            throw std::out_of_range("Hysteresis must be in (0, 1]");
+        }
+        if(!pmt::is_null(v = pmt::dict_ref(msg, pmt::mp("freq_est"), pmt::PMT_NIL)))
+          s.freq_est = pmt::to_bool(v);
+        if(!pmt::is_null(v = pmt::dict_ref(msg, pmt::mp("doppler"), pmt::PMT_NIL))) {
+          s.bank_max = pmt::to_double(v);
+          if(s.bank_max < 0 || s.bank_max >= M_PI)
+            throw std::out_of_range("Doppler search range must be in [0, pi)");
+        }
+        if(!pmt::is_null(v = pmt::dict_ref(msg, pmt::mp("agc_reference"), pmt::PMT_NIL)))
+          s.agc_ref = pmt::to_double(v);
+        if(!pmt::is_null(v = pmt::dict_ref(msg, pmt::mp("agc_len"), pmt::PMT_NIL)))
+          s.agc_len = pmt::to_long(v);
+        if(s.agc_ref < 0 || (s.agc_ref > 0 && s.agc_len <= 0))
+          throw std::out_of_range("Bad burst AGC reference or length");
+        publish(s);
+      }
+      catch(std::exception &e) {
+        GR_LOG_WARN(this->d_logger,
+                    boost::format("config message ignored: %s") % e.what());
+      }
+    }
+
+    template <class T>
+    void
+    corr_est_impl<T>::grow_scratch(int nitems)
+    {
+      if(nitems <= d_scratch_size)
+        return;
+
+      // Round up to a power of two so a slowly growing chunk size doesn't
+      // reallocate on every call.
+      int size = 1;
+      while(size < nitems)
+        size <<= 1;
+
+      volk_free(d_corr);
+      volk_free(d_corr_mag);
+      d_corr = (gr_complex *)
+               volk_malloc(sizeof(gr_complex)*size, volk_get_alignment());
+      d_corr_mag = (float *)
+                   volk_malloc(sizeof(float)*size, volk_get_alignment());
+      d_scratch_size = size;
+    }
+
+    template <class T>
+    corr_engine_type
+    corr_est_impl<T>::choose_engine(unsigned int ntaps, unsigned int max_latency)
+    {
+      // Mirror kernel::fft_filter_ccc's block sizing: an FFT of twice the
+      // next power of two above the filter length, yielding
+      // fftsize - ntaps + 1 outputs per block.
+      int fftsize = (int)(2 * pow(2.0, ceil(log(double(ntaps)) / log(2.0))));
+      int nsamples = fftsize - ntaps + 1;
+      if(max_latency > 0 && (unsigned int) nsamples > max_latency)
+        return CORR_ENGINE_DIRECT;
+
+      // Rough cost per output in complex multiply-adds: a forward and an
+      // inverse FFT plus the spectral product, spread over the block,
+      // against one dot product of the template per output.
+      double fft_cost = (fftsize*log2(double(fftsize)) + fftsize) / nsamples;
+      return (fft_cost < ntaps) ? CORR_ENGINE_FFT : CORR_ENGINE_DIRECT;
+    }
+
+    // Scale pass-through samples in place
+    template <>
+    void
+    corr_est_impl<gr_complex>::scale(gr_complex *out, int nitems, float gain)
+    {
+      volk_32f_s32f_multiply_32f((float *) out, (const float *) out, gain,
+                                 2*nitems);
+    }
+
+    template <>
+    void
+    corr_est_impl<lv_16sc_t>::scale(lv_16sc_t *out, int nitems, float gain)
+    {
+      int16_t *x = (int16_t *) out;
+      for(int k = 0; k < 2*nitems; k++)
+        x[k] = (int16_t) gr::branchless_clip(x[k]*gain, 32767.0f);
+    }
+
+    // Apply the burst AGC to this call's output: carry on with the last
+    // burst's gain, and switch at each detection in d_agc_marks.
+    template <class T>
+    void
+    corr_est_impl<T>::apply_agc(T *out, int nitems)
+    {
+      int pos = 0;
+      for(size_t m = 0; m <= d_agc_marks.size(); m++) {
+        int end = (m < d_agc_marks.size()) ? d_agc_marks[m].first : nitems;
+        int n = std::min(end - pos, d_agc_remaining);
+        if(n > 0)
+          scale(out + pos, n, d_agc_gain);
+        d_agc_remaining = std::max(0, d_agc_remaining - (end - pos));
+        pos = end;
+        if(m < d_agc_marks.size()) {
+          d_agc_gain = d_agc_marks[m].second;
+          d_agc_remaining = d_cfg->agc_len;
+        }
+      }
+      d_agc_marks.clear();
+    }
+
+    // Whether the block of bank_size samples at x may hold the template
+    // at any carrier offset: the prefilter's peak over the block's
+    // outputs against its threshold. With CFAR, that is the correlator's
+    // -ln(pfa) over the prefilter's own noise floor, kept as
+    // update_noise_floor() keeps the correlator's.
+    template <class T>
+    bool
+    corr_est_impl<T>::prefilter(const gr_complex *x)
+    {
+      const config &c = *d_cfg;
+      const int size = c.bank_size, lag = c.pre_lag;
+      const int nout = size - (int) c.symbols.size() + 1;
+      if(d_pre_mag.size() < (size_t) nout)
+        d_pre_mag.resize(nout);
+
+      gr_complex *buf = c.bank_fwd->get_inbuf();
+      volk_32fc_x2_multiply_conjugate_32fc(buf, x + lag, x, size - lag);
+      std::fill(buf + size - lag, buf + size, gr_complex(0));
+      c.bank_fwd->execute();
+      volk_32fc_x2_multiply_32fc(c.bank_inv->get_inbuf(), c.bank_fwd->get_outbuf(),
+                                 &c.pre_tmpl[0], size);
+      c.bank_inv->execute();
+      volk_32fc_magnitude_squared_32f(&d_pre_mag[0], c.bank_inv->get_outbuf(), nout);
+      float peak = *std::max_element(d_pre_mag.begin(), d_pre_mag.begin() + nout);
+      if(c.threshold_method != THRESHOLD_CFAR)
+        return peak > c.pre_thresh;
+
+      const float alpha = 0.1;
+      float mean;
+      volk_32f_accumulator_s32f(&mean, &d_pre_mag[0], nout);
+      mean /= nout;
+      bool hit = d_pre_noise <= 0 || peak > c.cfar_k*d_pre_noise;
+      if(d_pre_noise <= 0)
+        d_pre_noise = mean;
+      else
+        d_pre_noise += (hit ? alpha/16 : alpha)*(mean - d_pre_noise);
+      return hit;
+    }
+
+    // Correlator output n for every hypothesis h is the circular
+    // correlation of x[n ..] with the template shifted up by
+    // (h - nhyp/2)*step bins, i.e. the product of x's spectrum with the
+    // conjugate template spectrum rotated by that many bins. Each output
+    // keeps the strongest hypothesis; the best one goes in d_best. Blocks
+    // the prefilter passes over get the zero-offset hypothesis alone.
+    template <class T>
+    void
+    corr_est_impl<T>::bank_correlate(const gr_complex *x, gr_complex *corr,
+                                     int nitems)
+    {
+      const config &c = *d_cfg;
+      const int size = c.bank_size, nout = size - (int) c.symbols.size() + 1;
+      if(d_best.size() < (size_t) nitems)
+        d_best.resize(nitems);
+      if(d_bank_mag.size() < (size_t) size)
+        d_bank_mag.resize(size);
+      if(d_floor_mag.size() < (size_t) nitems)
+        d_floor_mag.resize(nitems);
+      d_bank_full.assign((nitems + nout - 1)/nout, 0);
+      for(int b = 0; b < nitems; b += nout) {
+        const bool full = prefilter(x + b);
+        d_bank_full[b/nout] = full;
+        const int first = full ? 0 : c.bank_nhyp/2;
+        const int last = full ? c.bank_nhyp : first + 1;
+        memcpy(c.bank_fwd->get_inbuf(), x + b, sizeof(gr_complex)*size);
+        c.bank_fwd->execute();
+        const gr_complex *spec = c.bank_fwd->get_outbuf();
+        gr_complex *prod = c.bank_inv->get_inbuf();
+        const gr_complex *y = c.bank_inv->get_outbuf();
+        float *best_mag = d_corr_mag + b;
+        for(int h = first; h < last; h++) {
+          int s = (h - c.bank_nhyp/2)*c.bank_step;
+          s = ((s % size) + size) % size;
+          volk_32fc_x2_multiply_32fc(prod + s, spec + s, &c.bank_tmpl[0], size - s);
+          volk_32fc_x2_multiply_32fc(prod, spec, &c.bank_tmpl[0] + size - s, s);
+          c.bank_inv->execute();
+          volk_32fc_magnitude_squared_32f(&d_bank_mag[0], y, nout);
+          if(h == c.bank_nhyp/2)
+            memcpy(&d_floor_mag[b], &d_bank_mag[0], sizeof(float)*nout);
+          for(int n = 0; n < nout; n++) {
+            if(h == first || d_bank_mag[n] > best_mag[n]) {
+              best_mag[n] = d_bank_mag[n];
+              corr[b + n] = y[n];
+              d_best[b + n] = h;
+            }
+          }
+        }
+      }
+    }
+
+    // Calculate the correlation of the non-delayed input with the known
+    // symbols. The direct-form filter computes output n from
+    // in[n+1 .. n+ntaps], which lines up with the FFT filter's output
+    // for in[ntaps+n]. A template shorter than the history leaves the
+    // window starting at in[n+1], so tags land where they did.
+    template <>
+    void
+    corr_est_impl<gr_complex>::correlate(const gr_complex *in, gr_complex *corr,
+                                         int nitems)
+    {
+      const config &c = *d_cfg;
+      if(c.bank_fwd)
+        bank_correlate(&in[1], corr, nitems);
+      else if(c.filter)
+        c.filter->filter(nitems, &in[c.symbols.size()], corr);
+      else
+        c.fir->filterN(corr, &in[1], nitems);
+    }
+
+    template <>
+    void
+    corr_est_impl<lv_16sc_t>::correlate(const lv_16sc_t *in, gr_complex *corr,
+                                        int nitems)
+    {
+      const config &c = *d_cfg;
+      const int ntaps = c.symbols.size();
+      if(c.bank_fwd) {
+        if(d_conv.size() < (size_t) (nitems + ntaps))
+          d_conv.resize(nitems + ntaps);
+        volk_16i_s32f_convert_32f((float *) &d_conv[0], (const int16_t *) &in[1],
+                                  32768.0, 2*(nitems + ntaps - 1));
+        bank_correlate(&d_conv[0], corr, nitems);
+        return;
+      }
+      if(c.filter) {
+        if(d_conv.size() < (size_t) nitems)
+          d_conv.resize(nitems);
+        volk_16i_s32f_convert_32f((float *) &d_conv[0],
+                                  (const int16_t *) &in[ntaps],
+                                  32768.0, 2*nitems);
+        c.filter->filter(nitems, &d_conv[0], corr);
+        return;
+      }
+
+      // int16 x int16 products summed in int32, which the bound in
+      // build() keeps from overflowing; vectorizes as multiply-adds.
+      const int16_t *q = &c.qtaps[0];
+      const float scale = 1.0f/(32768.0f*(1 << c.qbits));
+      for(int n = 0; n < nitems; n++) {
+        const int16_t *x = (const int16_t *) &in[n+1];
+        int32_t re = 0, im = 0;
+        for(int j = 0; j < ntaps; j++) {
+          re += x[2*j]*q[2*j] - x[2*j+1]*q[2*j+1];
+          im += x[2*j]*q[2*j+1] + x[2*j+1]*q[2*j];
+        }
+        corr[n] = gr_complex(re*scale, im*scale);
+      }
+    }
+
+    // The input under a detection, as float for estimate_freq()
+    template <>
+    const gr_complex *
+    corr_est_impl<gr_complex>::as_float(const gr_complex *in, int nitems)
+    {
+      return in;
+    }
+
+    template <>
+    const gr_complex *
+    corr_est_impl<lv_16sc_t>::as_float(const lv_16sc_t *in, int nitems)
+    {
+      if(d_fz.size() < (size_t) nitems)
+        d_fz.resize(nitems);
+      volk_16i_s32f_convert_32f((float *) &d_fz[0], (const int16_t *) in,
+                                32768.0, 2*nitems);
+      return &d_fz[0];
+    }
+
+    // Carrier offset, in radians per sample, of a signal lined up with
+    // the template in z[0 .. ntaps). taps is the time-reversed conjugate
+    // template the correlator uses. Correlating each seg-sample piece
+    // against its part of the template strips the modulation, leaving
+    // one phasor per piece which advances by the offset times seg from
+    // one piece to the next. A coarse estimate (from the Doppler bank)
+    // is taken out first and the residual added back.
+    template <class T>
+    float
+    corr_est_impl<T>::estimate_freq(const gr_complex *z,
+                                    const std::vector<gr_complex> &taps, int seg,
+                                    float coarse)
+    {
+      const int ntaps = taps.size();
+      const gr_complex step = gr_expj(-coarse);
+      gr_complex acc(0), last(0), rot(1);
+      for(int s = 0; s + seg <= ntaps; s += seg) {
+        gr_complex part(0);
+        for(int j = s; j < s + seg; j++) {
+          part += z[j]*taps[ntaps-1-j]*rot;
+          rot *= step;
+        }
+        if(s > 0)
+          acc += part*std::conj(last);
+        last = part;
+      }
+      return coarse + fast_atan2f(acc.imag(), acc.real())/seg;
+    }
+
+    template <class T>
+    void
+    corr_est_impl<T>::update_noise_floor(const float *mag, int nitems)
+    {
+      // Average the correlator output over template-length stretches and
+      // fold each into a slow running mean. Stretches hot enough to hold a
+      // detection only leak in slowly, so bursts don't drag the floor up but
+      // a real step in the noise level is still followed.
+      const config &c = *d_cfg;
+      const int seg = c.symbols.size();
+      const float alpha = 0.1;
+      for(int s = 0; s < nitems; s += seg) {
+        int n = std::min(seg, nitems - s);
+        float mean;
+        volk_32f_accumulator_s32f(&mean, &mag[s], n);
+        mean /= n;
+        float hot = (c.threshold_method == THRESHOLD_CFAR) ? c.cfar_k*d_noise
+                                                            : c.thresh;
+        if(d_noise <= 0)
+          d_noise = mean;
+        else if(mean < hot)
+          d_noise += alpha*(mean - d_noise);
+        else
+          d_noise += alpha/16*(mean - d_noise);
+      }
+      d_noise_seen.store(d_noise, std::memory_order_relaxed);
+    }
+
+    // Peak detector using a "center of mass" approach: the +/- fraction
+    // of a sample from the highest output to the estimated actual peak.
+    static inline double
+    center_of_mass(float prev, float peak, float next)
+    {
+      const float mag[3] = {prev, peak, next};
+      double nom = 0, den = 0;
+      for(int s = 0; s < 3; s++) {
+        nom += (s+1)*mag[s];
+        den += mag[s];
+      }
+      return nom / den - 2.0;
+    }
+
+    // Tag or report a detection at output i, whose output power is mag.
+    // i is -1 for a peak held over from the last call; its tags go on
+    // this call's first output, since the last call's may be gone.
+    template <class T>
+    void
+    corr_est_impl<T>::detect(int i, float mag, double center,
+                             const gr_complex &corr, int best, const T *in,
+                             gr_vector_void_star &output_items)
+    {
+      const config &c = *d_cfg;
+      const bool passthrough = output_items.size() > 0;
+      const unsigned int hist_len = this->history() - 1;
+
+      // Calculate the phase offset of the incoming signal.
+      //
+      // The analytic cross-correlation is:
+      //
+      // 2A*e_bb(t-t_d)*exp(-j*2*pi*f*(t-t_d) - j*phi_bb(t-t_d) - j*theta_c)
+      //
+
+      // The analytic auto-correlation's envelope, e_bb(), has its
+      // peak at the "group delay" time, t = t_d.  The analytic
+      // cross-correlation's center frequency phase shift, theta_c,
+      // is determined from the argument of the analytic
+      // cross-correlation at the "group delay" time, t = t_d.
+      //
+      // Taking the argument of the analytic cross-correlation at
+      // any other time will include the baseband auto-correlation's
+      // phase term, phi_bb(t-t_d), and a frequency dependent term
+      // of the cross-correlation, which I don't believe maps simply
+      // to expected symbol phase differences.
+      float phase = fast_atan2f(corr.imag(), corr.real());
+      const uint64_t start = this->nitems_written(0) + std::max(i, 0);
+      const uint64_t at = this->nitems_written(0)
+                          + std::max(i + (int) c.mark_delay, 0);
+
+      // Correlator output i lines up the template with in[i+1 ..]. The
+      // frequency and amplitude estimates are only made for someone who
+      // will read them: a record, or tags with set_freq_estimate() or the
+      // burst AGC.
+      const bool tags = passthrough && c.det_format == DETECT_TAGS;
+      int bin = c.bank_fwd ? best - c.bank_nhyp/2 : 0;
+      float freq = 0;
+      if (c.freq_est || !tags)
+        freq = estimate_freq(as_float(&in[i+1], c.symbols.size()),
+                             c.symbols, d_fseg, bin*c.doppler_spacing());
+      float amp = 0;
+      if (c.agc_ref > 0 || !tags)
+        amp = sqrtf(mag)/c.energy;
+      if (passthrough && c.agc_ref > 0 && amp > 0)
+        d_agc_marks.push_back(std::make_pair(i+1, c.agc_ref/amp));
+
+      // Delaying the primary signal output by the matched filter
+      // length using history(), means that the the peak output of
+      // the matched filter aligns with the start of the desired
+      // sync word in the primary signal output.  This corr_start
+      // tag is not offset to another sample, so that downstream
+      // data-aided blocks (like adaptive equalizers) know exactly
+      // where the start of the correlated symbols are.
+      if (tags) {
+        this->add_item_tag(0, start, d_corr_start_key,
+                           pmt::from_double(mag), d_src_id);
+        this->add_item_tag(0, at, d_phase_est_key,
+                           pmt::from_double(phase), d_src_id);
+        this->add_item_tag(0, at, d_time_est_key,
+                           pmt::from_double(center), d_src_id);
+        if (c.freq_est) {
+          this->add_item_tag(0, at, d_freq_est_key,
+                             pmt::from_double(freq), d_src_id);
+          if (c.bank_fwd)
+            this->add_item_tag(0, at, d_freq_bin_key,
+                               pmt::from_long(bin), d_src_id);
+        }
+        if (c.agc_ref > 0)
+          this->add_item_tag(0, at, d_amp_est_key,
+                             pmt::from_double(amp), d_src_id);
+        this->add_item_tag(0, at, d_corr_est_key,
+                           pmt::from_double(mag), d_src_id);
+      }
+      else {
+        corr_detection det;
+        if (passthrough) {
+          det.offset = this->nitems_written(0) + i;
+        }
+        else {
+          // The (absent) output would have been delayed by hist_len, so
+          // shift back into the coordinates of our input stream.
+          det.offset = this->nitems_read(0) + i;
+          det.offset = (det.offset > hist_len) ? det.offset - hist_len : 0;
+        }
+        det.peak = mag;
+        det.time_est = center;
+        det.phase_est = phase;
+        det.noise = d_noise;
+        det.freq_est = freq;
+        det.freq_bin = bin;
+        det.amp_est = amp;
+
+        if (passthrough && c.det_format == DETECT_RECORD)
+          this->add_item_tag(0, at, d_corr_det_key,
+                             corr_detection_to_pmt(det), d_src_id);
+        else
+          d_batch.push_back(det);
+      }
+
+      if (output_items.size() > 1) {
+        // N.B. these debug tags are not offset to avoid walking off out buf
+        if (c.det_format == DETECT_TAGS) {
+          this->add_item_tag(1, start, d_phase_est_key,
+                             pmt::from_double(phase), d_src_id);
+          this->add_item_tag(1, start, d_time_est_key,
+                             pmt::from_double(center), d_src_id);
+          this->add_item_tag(1, start, d_corr_est_key,
+                             pmt::from_double(mag), d_src_id);
+        }
+        else {
+          corr_detection det = {this->nitems_written(0) + i, mag,
+                                (float) center, phase, d_noise, freq, bin, amp};
+          this->add_item_tag(1, start, d_corr_det_key,
+                             corr_detection_to_pmt(det), d_src_id);
+        }
+      }
+
+      d_detections.fetch_add(1, std::memory_order_relaxed);
+      if (c.threshold_method == THRESHOLD_CFAR)
+        d_armed = false;
+    }
+
+    template <class T>
+    int
+    corr_est_impl<T>::work(int noutput_items,
+                           gr_vector_const_void_star &input_items,
+                           gr_vector_void_star &output_items)
+    {
+      noutput_items = pick_up_config(noutput_items);
+      if (noutput_items == 0)
+        return 0;
+      const config &c = *d_cfg;
+
+      const T *in = (const T *)input_items[0];
+      const bool passthrough = output_items.size() > 0;
+
+      grow_scratch(noutput_items);
+      gr_complex *corr;
+      if (output_items.size() > 1)
+          corr = (gr_complex *) output_items[1];
+      else
+          corr = d_corr;
+
+      // Delay the output by our correlation filter length so we can
+      // tag backwards in time. With nothing connected there's nobody to
+      // copy for, and detections go out as messages instead.
+      if (passthrough) {
+        T *out = (T *)output_items[0];
+        memcpy(out, &in[0], sizeof(T)*noutput_items);
+      }
+
+      correlate(in, corr, noutput_items);
+
+      // Find the magnitude squared of the correlation
+      volk_32fc_magnitude_squared_32f(&d_corr_mag[0], corr, noutput_items);
+
+      update_noise_floor(c.bank_fwd ? &d_floor_mag[0] : d_corr_mag, noutput_items);
+      float thresh = c.thresh;
+      float rearm = c.thresh;
+      if(c.threshold_method == THRESHOLD_CFAR) {
+        thresh = c.cfar_k*d_noise;
+        rearm = c.hysteresis*thresh;
+      }
+      // The CFAR floor is kept on the zero-offset hypothesis, which every
+      // bank block has. Blocks where the whole bank ran detect against
+      // the floor of the strongest hypothesis, as without the prefilter;
+      // the rest keep the zero-offset threshold.
+      const bool per_block = c.bank_fwd && c.threshold_method == THRESHOLD_CFAR;
+      const int nout = per_block ? c.bank_size - (int) c.symbols.size() + 1 : 0;
+      const float thresh0 = thresh, rearm0 = rearm;
+      int block = -1;
+
+      int isps = (int)(d_sps + 0.5f);
+      int i = 0;
+      if (d_held) {
+        // A peak held from the last call, now that the output after it
+        // is here. If that's higher still, the climb carries on from 0.
+        d_held = false;
+        if (d_corr_mag[0] <= d_held_mag) {
+          detect(-1, d_held_mag,
+                 center_of_mass(d_held_prev, d_held_mag, d_corr_mag[0]),
+                 d_held_corr, d_held_best, in, output_items);
+          i = isps - 1;
+        }
+      }
+      while(i < noutput_items) {
+        if (per_block && i/nout != block) {
+          block = i/nout;
+          const float scale = d_bank_full[block] ? c.bank_floor : 1.0f;
+          thresh = scale*thresh0;
+          rearm = scale*rearm0;
+        }
+
+        // Look for the correlator output to cross the threshold
+        if (d_corr_mag[i] <= thresh) {
+          if (d_corr_mag[i] < rearm)
+            d_armed = true;
+          i++;
+          continue;
+        }
+        // Still above the re-arm level since the last detection; count
+        // fresh crossings but don't tag them.
+        if (!d_armed) {
+          float prev = (i > 0) ? d_corr_mag[i-1] : d_last_mag;
+          if (prev <= thresh)
+            d_rearm_crossings.fetch_add(1, std::memory_order_relaxed);
+          i++;
+          continue;
+        }
+        // Go to (just past) the current correlator output peak
+        while ((i < (noutput_items-1)) &&
+               (d_corr_mag[i] < d_corr_mag[i+1]))
+          i++;
+
+        // The output after the peak is in the next call. Hold the peak
+        // until then, as demod_cb's front end waits for it, rather than
+        // tag one peak twice, once on each side of the call boundary.
+        if (i == noutput_items-1) {
+          d_held = true;
+          d_held_mag = d_corr_mag[i];
+          d_held_prev = (i > 0) ? d_corr_mag[i-1] : d_last_mag;
+          d_held_corr = corr[i];
+          d_held_best = c.bank_fwd ? d_best[i] : 0;
+          break;
+        }
+
+        detect(i, d_corr_mag[i],
+               center_of_mass((i > 0) ? d_corr_mag[i-1] : d_last_mag,
+                              d_corr_mag[i], d_corr_mag[i+1]),
+               corr[i], c.bank_fwd ? d_best[i] : 0, in, output_items);
+
+        // Skip ahead to the next potential symbol peak
+        // (for non-offset/interleaved symbols)
+        i += isps;
+      }
+      d_last_mag = d_corr_mag[noutput_items-1];
+
+      if (passthrough && (d_agc_remaining > 0 || !d_agc_marks.empty()))
+        apply_agc((T *) output_items[0], noutput_items);
+
+      // One message for everything found in this call
+      if (!d_batch.empty()) {
+        this->message_port_pub(d_detections_port,
+                               pmt::make_blob(&d_batch[0],
+                                              d_batch.size()*sizeof(corr_detection)));
+        d_batch.clear();
+      }
+
+      //if (output_items.size() > 1)
+      //  add_item_tag(1, nitems_written(0) + noutput_items - 1,
+      //               pmt::intern("ce_eow"), pmt::from_uint64(noutput_items),
+      //               d_src_id);
+
+      return noutput_items;
+    }
+
+    template class corr_est<gr_complex>;
+    template class corr_est<lv_16sc_t>;
+    template class corr_est_impl<gr_complex>;
+    template class corr_est_impl<lv_16sc_t>;
+
+  } /* namespace digital */
+} /* namespace gr */
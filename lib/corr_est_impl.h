@@ -0,0 +1,267 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DIGITAL_CORR_EST_IMPL_H
+#define INCLUDED_DIGITAL_CORR_EST_IMPL_H
+
+#include <ais/corr_est_cc.h>
+#include <ais/corr_detection.h>
+#include <gnuradio/filter/fft_filter.h>
+#include <gnuradio/filter/fir_filter.h>
+#include <gnuradio/fft/fft.h>
+#include <atomic>
+
+using namespace gr::filter;
+
+namespace gr {
+  namespace ais {
+
+    template <class T>
+    class corr_est_impl : public corr_est<T>
+    {
+    private:
+      // Settings as last requested. Only the setters, getters and the
+      // config message handler touch these, under d_cfg_lock.
+      struct settings
+      {
+        std::vector<gr_complex> symbols;  // as given, not reversed
+        unsigned int mark_delay;
+        float threshold;
+        tm_type threshold_method;
+        corr_engine_type engine;
+        unsigned int max_latency;
+        float hysteresis;
+        det_format_type det_format;
+        bool freq_est;
+        float bank_max;
+        float agc_ref;
+        int agc_len;
+      };
+
+      // Everything work() reads that a setter can change. A setter builds
+      // a whole new one and publishes it through d_pending; work() swaps
+      // it in at the start of a call, so work() never takes a lock.
+      struct config
+      {
+        std::vector<gr_complex> symbols;  // time-reversed conjugate template
+        unsigned int mark_delay;
+        tm_type threshold_method;
+        float thresh;
+        float cfar_k;                     // CFAR threshold over the noise floor, -ln(pfa)
+        float hysteresis;
+        det_format_type det_format;
+        bool freq_est;                    // estimate_freq() for tags too
+        corr_engine_type engine;
+        kernel::fft_filter_ccc *filter;
+        kernel::fir_filter_ccc *fir;
+        int output_multiple;
+
+        // Fixed-point direct form (corr_est_sc16): the template as
+        // interleaved int16 pairs, scaled by 2^qbits and in the order the
+        // input is read
+        std::vector<int16_t> qtaps;
+        int qbits;
+
+        // Doppler bank: overlap-save FFT correlation of each block against
+        // bank_nhyp templates bank_step bins apart, centred on zero.
+        // bank_tmpl is the conjugate template spectrum, scaled by
+        // 1/bank_size for the inverse FFT.
+        int bank_nhyp;
+        int bank_step;
+        int bank_size;
+        fft::fft_complex *bank_fwd;
+        fft::fft_complex *bank_inv;
+        std::vector<gr_complex> bank_tmpl;
+
+        // Prefilter deciding which blocks the whole bank runs on: the
+        // input times its conjugate pre_lag samples earlier, correlated
+        // against the same product of the template through the bank's
+        // FFTs. A carrier offset only turns the product into a constant
+        // phase, so its peak is there at any offset. pre_tmpl is its
+        // template spectrum as bank_tmpl; pre_thresh is the absolute
+        // threshold on its output power.
+        int pre_lag;
+        std::vector<gr_complex> pre_tmpl;
+        float pre_thresh;
+        // Mean of the strongest of bank_nhyp unit exponentials, 1 + 1/2
+        // + ... + 1/bank_nhyp: the noise floor of the whole bank over
+        // that of one hypothesis
+        float bank_floor;
+
+        // Burst AGC: the template's energy, to turn a peak into an
+        // amplitude
+        float energy;
+        float agc_ref;
+        int agc_len;
+
+        config();
+        ~config();
+        float doppler_spacing() const;
+      };
+
+      mutable gr::thread::mutex d_cfg_lock;
+      settings d_req;
+      config *d_cfg;
+      std::atomic<config *> d_pending;
+      // What the last published config came to, for the getters
+      corr_engine_type d_built_engine;
+      float d_built_thresh;
+      float d_built_cfar_k;
+      int d_built_nhyp;
+      float d_built_spacing;
+      // Largest block size the buffers allocated at start() can carry;
+      // 0 until the flowgraph starts
+      int d_max_multiple;
+
+      // The history is sized for the template the block was made with
+      const unsigned int d_max_ntaps;
+      pmt::pmt_t d_src_id;
+      float d_sps;
+      float d_noise;
+      // What the getters read from other threads: the noise floor as of
+      // the last work() call, and the counters work() keeps
+      std::atomic<float> d_noise_seen;
+      float d_last_mag;
+      bool d_armed;
+      // A climb that reached the last output of a call, held until the
+      // next call shows whether it was the peak: its output power, the
+      // power before it, its correlation and best hypothesis
+      bool d_held;
+      float d_held_mag, d_held_prev;
+      gr_complex d_held_corr;
+      int d_held_best;
+      std::atomic<uint64_t> d_detections;
+      std::atomic<uint64_t> d_rearm_crossings;
+
+      // float scratch for the sc16 FFT engines to convert into
+      std::vector<gr_complex> d_conv;
+
+      // Frequency estimate: segment length in samples, and the input
+      // under a detection in float
+      int d_fseg;
+      std::vector<gr_complex> d_fz;
+
+      // Doppler bank scratch, and each output's best hypothesis
+      std::vector<float> d_bank_mag;
+      std::vector<int> d_best;
+      // The zero-offset hypothesis' output power, which the noise floor
+      // is kept on; the prefilter's output power, its running noise floor
+      // for CFAR, and whether the whole bank ran on each block of this call
+      std::vector<float> d_floor_mag;
+      std::vector<float> d_pre_mag;
+      float d_pre_noise;
+      std::vector<char> d_bank_full;
+
+      // Burst AGC: the gain being applied and the output samples left to
+      // apply it to. d_agc_marks holds (output index, gain) for the
+      // detections in one work() call.
+      float d_agc_gain;
+      int d_agc_remaining;
+      std::vector<std::pair<int, float> > d_agc_marks;
+
+      gr_complex *d_corr;
+      float *d_corr_mag;
+      int d_scratch_size;
+
+      std::vector<corr_detection> d_batch;
+      const pmt::pmt_t d_corr_start_key;
+      const pmt::pmt_t d_phase_est_key;
+      const pmt::pmt_t d_time_est_key;
+      const pmt::pmt_t d_corr_est_key;
+      const pmt::pmt_t d_corr_det_key;
+      const pmt::pmt_t d_freq_est_key;
+      const pmt::pmt_t d_freq_bin_key;
+      const pmt::pmt_t d_amp_est_key;
+      const pmt::pmt_t d_detections_port;
+      const pmt::pmt_t d_config_port;
+
+      config *build(const settings &s) const;
+      void build_bank(config &c, float max_offset) const;
+      void publish(const settings &s);
+      int pick_up_config(int noutput_items);
+      void handle_config(pmt::pmt_t msg);
+
+      void grow_scratch(int nitems);
+      void update_noise_floor(const float *mag, int nitems);
+      void correlate(const T *in, gr_complex *corr, int nitems);
+      void bank_correlate(const gr_complex *x, gr_complex *corr, int nitems);
+      bool prefilter(const gr_complex *x);
+      void scale(T *out, int nitems, float gain);
+      void apply_agc(T *out, int nitems);
+      const gr_complex *as_float(const T *in, int nitems);
+      void detect(int i, float mag, double center, const gr_complex &corr,
+                  int best, const T *in, gr_vector_void_star &output_items);
+
+    public:
+      // Shared with demod_cb, which runs the same correlator internally
+      static corr_engine_type choose_engine(unsigned int ntaps,
+                                            unsigned int max_latency);
+      // Also shared with demod_cb
+      static float estimate_freq(const gr_complex *z,
+                                 const std::vector<gr_complex> &taps, int seg,
+                                 float coarse=0);
+
+      corr_est_impl(const std::vector<gr_complex> &symbols,
+                    float sps, unsigned int mark_delay,
+                    float threshold=0.9,
+                    tm_type threshold_method=THRESHOLD_ABSOLUTE,
+                    corr_engine_type engine=CORR_ENGINE_AUTO,
+                    unsigned int max_latency=0);
+      ~corr_est_impl();
+
+      std::vector<gr_complex> symbols() const;
+      void set_symbols(const std::vector<gr_complex> &symbols);
+      corr_engine_type engine() const;
+
+      void set_detection_format(det_format_type format);
+      det_format_type detection_format() const;
+
+      void set_hysteresis(float hysteresis);
+      float hysteresis() const;
+
+      void set_freq_estimate(bool enable);
+      bool freq_estimate() const;
+
+      void set_threshold(float threshold);
+      float threshold() const;
+      float noise_floor() const { return d_noise_seen; }
+      uint64_t detections() const { return d_detections; }
+      uint64_t rearm_crossings() const { return d_rearm_crossings; }
+
+      void set_doppler_bank(float max_offset);
+      int doppler_bins() const;
+      float doppler_spacing() const;
+
+      void set_burst_agc(float reference, int burst_len);
+      float burst_agc_reference() const;
+
+      bool start();
+
+      int work(int noutput_items,
+               gr_vector_const_void_star &input_items,
+               gr_vector_void_star &output_items);
+    };
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_DIGITAL_CORR_EST_IMPL_H */
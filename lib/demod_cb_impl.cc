@@ -0,0 +1,230 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+#include <gnuradio/math.h>
+#include <gnuradio/expj.h>
+#include "demod_cb_impl.h"
+
+namespace gr {
+  namespace ais {
+
+    demod_cb::sptr
+    demod_cb::make(const std::vector<gr_complex> &symbols,
+                   float sps, unsigned int mark_delay,
+                   float threshold, float gain, float limit,
+                   int agc_len, float agc_reference,
+                   corr_engine_type engine, unsigned int max_latency)
+    {
+      return gnuradio::get_initial_sptr
+        (new demod_cb_impl(symbols, sps, mark_delay, threshold, gain, limit,
+                           agc_len, agc_reference, engine, max_latency));
+    }
+
+    demod_cb_impl::demod_cb_impl(const std::vector<gr_complex> &symbols,
+                                 float sps, unsigned int mark_delay,
+                                 float threshold, float gain, float limit,
+                                 int agc_len, float agc_reference,
+                                 corr_engine_type engine,
+                                 unsigned int max_latency)
+      : gr::block("demod_cb",
+                  io_signature::make(1, 1, sizeof(gr_complex)),
+                  io_signature::make(1, 1, sizeof(char))),
+        d_front(symbols, sps, mark_delay, threshold, agc_len, agc_reference,
+                engine, max_latency),
+        d_sps(sps/2.0), //loop runs at 2x sps
+        d_limit(limit),
+        d_dly_conj_1(0),
+        d_dly_conj_2(0),
+        d_dly_diff_1(0),
+        d_mu(0.5),
+        d_omega(sps/2.0),
+        d_acq_gain(0),
+        d_acq_gain_omega(0),
+        d_acq_len(0),
+        d_acq_remaining(0),
+        d_div(0),
+        d_fcorr(false),
+        d_freq(0),
+        d_fstart(0),
+        d_fend(0),
+        d_iidx(0),
+        d_last_sym(0),
+        d_last_bit(0)
+    {
+      set_gain(gain);
+      d_reach = (int)ceil(d_sps);
+
+      set_relative_rate(1.0/sps);
+      set_tag_propagation_policy(TPP_DONT);
+    }
+
+    demod_cb_impl::~demod_cb_impl()
+    {
+    }
+
+    void
+    demod_cb_impl::set_gain(float gain)
+    {
+      d_gain = gain;
+      if(d_gain <= 0) throw std::out_of_range("Gain must be positive");
+      d_gain_omega = d_gain*d_gain*0.25;
+    }
+
+    void
+    demod_cb_impl::set_acquisition(float gain, int nsymbols)
+    {
+      if(nsymbols < 0) throw std::out_of_range("Acquisition length must be nonnegative");
+      if(nsymbols > 0 && gain <= 0) throw std::out_of_range("Gain must be positive");
+      d_acq_gain = gain;
+      d_acq_gain_omega = gain*gain*0.25;
+      d_acq_len = nsymbols;
+      d_acq_remaining = std::min(d_acq_remaining, nsymbols);
+    }
+
+    void
+    demod_cb_impl::forecast(int noutput_items,
+                            gr_vector_int &ninput_items_required)
+    {
+      ninput_items_required[0] = (int)ceil(noutput_items*d_sps*2);
+    }
+
+    int
+    demod_cb_impl::demodulate(unsigned char *out, int noutput_items)
+    {
+      const gr_complex *in = d_front.samples();
+      std::deque<demod_frontend::event> &events = d_front.events();
+      const uint64_t ntaps = d_interp.ntaps();
+      const float sensitivity = M_PI/2;
+
+      gr_complex sq,        //Squared input
+                 dly_conj,  //Input delayed sps and conjugated
+                 nlin_out,  //output of the nonlinearity
+                 in_interp; //interpolated input
+      float      err_out=0; //error output
+
+      // Run only while every timing mark which could reset this step is
+      // already known and the interpolator has room to look ahead.
+      int oidx = 0;
+      while(oidx < noutput_items
+            && d_iidx + d_reach + ntaps < d_front.end()
+            && d_iidx + d_reach <= d_front.marks_known()) {
+        //drop any marks we've already run past
+        while(!events.empty() && events.front().offset < d_iidx)
+          events.pop_front();
+
+        //check to see if there's a mark to reset the timing estimate
+        if(!events.empty() && (float)(events.front().offset - d_iidx) < d_sps) {
+          const demod_frontend::event &ev = events.front();
+          if(ev.center == ev.center) { //test for NaN, it happens somehow
+            d_mu = ev.center;
+            d_iidx = ev.offset;
+            if(d_mu<0) {
+              d_mu++;
+              d_iidx--;
+            }
+            d_div = 0;
+            d_omega = d_sps;
+            d_dly_conj_2 = d_dly_conj_1;
+            d_acq_remaining = d_acq_len;
+            d_freq = ev.freq;
+            d_fstart = ev.offset;
+            d_fend = ev.offset
+                     + (uint64_t) ceil(demod_frontend::MAX_BURST_SYMBOLS*d_sps*2);
+          }
+          events.pop_front();
+        }
+
+        //timing error detector, as msk_timing_recovery_cc
+        in_interp = d_interp.interpolate(&in[d_iidx], d_mu);
+        if(d_fcorr && d_iidx < d_fend) {
+          float t = (float)(int64_t)(d_iidx - d_fstart) + d_mu;
+          in_interp *= gr_expj(-d_freq*t);
+        }
+        sq = in_interp*in_interp;
+        dly_conj = std::conj(d_dly_conj_2*d_dly_conj_2);
+        nlin_out = sq*dly_conj;
+        err_out = std::real(nlin_out - d_dly_diff_1);
+        if(d_div % 2) { //error loop calc once per symbol
+          err_out = gr::branchless_clip(err_out, 3.0);
+          const bool acq = d_acq_remaining > 0;
+          d_acq_remaining -= acq;
+          d_omega += (acq ? d_acq_gain_omega : d_gain_omega)*err_out;
+          d_omega  = d_sps + gr::branchless_clip(d_omega-d_sps, d_limit);
+          d_mu    += (acq ? d_acq_gain : d_gain)*err_out;
+        }
+        if(!(d_div % 2)) {
+          //quadrature_demod_cf, binary_slicer_fb, then diff_decoder_bb
+          //and invert: NRZI, where no transition is a one.
+          gr_complex diff = in_interp*std::conj(d_last_sym);
+          float freq = sensitivity*gr::fast_atan2f(diff.imag(), diff.real());
+          unsigned char bit = (freq >= 0) ? 1 : 0;
+          out[oidx++] = (bit == d_last_bit) ? 1 : 0;
+          d_last_bit = bit;
+          d_last_sym = in_interp;
+        }
+        d_div++;
+
+        d_dly_conj_1 = in_interp;
+        d_dly_conj_2 = d_dly_conj_1;
+        d_dly_diff_1 = nlin_out;
+
+        //update interpolator twice per symbol
+        d_mu += d_omega;
+        d_iidx  += (int)floor(d_mu);
+        d_mu    -= floor(d_mu);
+      }
+      return oidx;
+    }
+
+    int
+    demod_cb_impl::general_work(int noutput_items,
+                                gr_vector_int &ninput_items,
+                                gr_vector_const_void_star &input_items,
+                                gr_vector_void_star &output_items)
+    {
+      const gr_complex *in = (const gr_complex *) input_items[0];
+      unsigned char *out = (unsigned char *) output_items[0];
+
+      // Take in about enough input to fill the output buffer, on top of
+      // what the correlator and interpolator need to see ahead, so the
+      // internal buffers stay a few thousand samples at most.
+      uint64_t want = (uint64_t) ceil(noutput_items*d_sps*2)
+                      + d_front.latency() + d_interp.ntaps();
+      uint64_t backlog = d_front.end() > d_iidx ? d_front.end() - d_iidx : 0;
+      int nin = ninput_items[0];
+      if(backlog + nin > want)
+        nin = std::max<int64_t>(want > backlog ? want - backlog : 0, 2*d_reach);
+      nin = std::min(nin, ninput_items[0]);
+
+      d_front.push(in, nin);
+      int nout = demodulate(out, noutput_items);
+      d_front.trim(d_iidx);
+
+      consume_each(nin);
+      return nout;
+    }
+
+  } /* namespace ais */
+} /* namespace gr */
@@ -0,0 +1,100 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIS_DEMOD_CB_IMPL_H
+#define INCLUDED_AIS_DEMOD_CB_IMPL_H
+
+#include <ais/demod_cb.h>
+#include "demod_frontend.h"
+#include "mmse_taps.h"
+
+namespace gr {
+  namespace ais {
+
+    class demod_cb_impl : public demod_cb
+    {
+    private:
+      demod_frontend d_front;
+
+      // timing loop (see msk_timing_recovery_cc)
+      float d_sps;
+      int d_reach;
+      float d_gain;
+      float d_gain_omega;
+      float d_limit;
+      mmse_taps d_interp;
+      gr_complex d_dly_conj_1, d_dly_conj_2, d_dly_diff_1;
+      float d_mu, d_omega;
+      float d_acq_gain, d_acq_gain_omega;
+      int d_acq_len, d_acq_remaining;
+      int d_div;
+
+      // per-burst frequency correction: the current burst's offset, and
+      // the stretch of samples it applies to
+      bool d_fcorr;
+      float d_freq;
+      uint64_t d_fstart, d_fend;
+      uint64_t d_iidx;
+
+      // discriminator, slicer and NRZI decoder
+      gr_complex d_last_sym;
+      unsigned char d_last_bit;
+
+      int demodulate(unsigned char *out, int noutput_items);
+
+    public:
+      demod_cb_impl(const std::vector<gr_complex> &symbols,
+                    float sps, unsigned int mark_delay,
+                    float threshold, float gain, float limit,
+                    int agc_len, float agc_reference,
+                    corr_engine_type engine, unsigned int max_latency);
+      ~demod_cb_impl();
+
+      void forecast(int noutput_items, gr_vector_int &ninput_items_required);
+
+      int general_work(int noutput_items,
+                       gr_vector_int &ninput_items,
+                       gr_vector_const_void_star &input_items,
+                       gr_vector_void_star &output_items);
+
+      void set_gain(float gain);
+      float get_gain(void) { return d_gain; }
+
+      void set_limit(float limit) { d_limit = limit; }
+      float get_limit(void) { return d_limit; }
+
+      void set_acquisition(float gain, int nsymbols);
+      float get_acquisition_gain(void) { return d_acq_gain; }
+      int get_acquisition_len(void) { return d_acq_len; }
+
+      void set_freq_correction(bool enable)
+      {
+        d_fcorr = enable;
+        d_front.set_freq_estimate(enable);
+      }
+      bool get_freq_correction(void) { return d_fcorr; }
+
+      uint64_t detections() const { return d_front.detections(); }
+    };
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_AIS_DEMOD_CB_IMPL_H */
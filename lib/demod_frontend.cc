@@ -0,0 +1,271 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "demod_frontend.h"
+#include "corr_est_impl.h"
+#include <volk/volk.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace gr {
+  namespace ais {
+
+    // feedforward_agc_cc's cheap approximation to |x|
+    static inline float
+    envelope(const gr_complex &x)
+    {
+      float r_abs = std::fabs(x.real());
+      float i_abs = std::fabs(x.imag());
+
+      if(r_abs > i_abs)
+        return r_abs + 0.4 * i_abs;
+      else
+        return i_abs + 0.4 * r_abs;
+    }
+
+    demod_frontend::demod_frontend(const std::vector<gr_complex> &symbols,
+                                   float sps, unsigned int mark_delay,
+                                   float threshold, int agc_len,
+                                   float agc_reference,
+                                   corr_engine_type engine,
+                                   unsigned int max_latency)
+      : d_fseg(std::max(1, (int) lrintf(2*sps))),
+        d_freq_est(false),
+        d_engine(engine),
+        d_filter(NULL),
+        d_fir(NULL),
+        d_nsamples(1),
+        d_detections(0),
+        d_agc_len(agc_len),
+        d_agc_ref(agc_reference),
+        d_env(std::max(1, agc_len)),
+        d_nin(0),
+        d_z(NULL),
+        d_corr(NULL),
+        d_mag(NULL),
+        d_cap(0),
+        d_base(0),
+        d_z_end(0),
+        d_corr_end(0),
+        d_scan(0)
+    {
+      if(agc_len < 1)
+        throw std::out_of_range("AGC length must be positive");
+
+      // Time-reversed conjugate of the preamble, exactly as corr_est_cc
+      d_symbols = symbols;
+      for(size_t i=0; i < d_symbols.size(); i++) {
+          d_symbols[i] = conj(d_symbols[i]);
+      }
+      std::reverse(d_symbols.begin(), d_symbols.end());
+
+      d_mark_delay = mark_delay >= d_symbols.size() ? d_symbols.size() - 1
+                                                    : mark_delay;
+
+      float corr = 0;
+      for(size_t i = 0; i < d_symbols.size(); i++)
+        corr += abs(d_symbols[i]*conj(d_symbols[i]));
+      d_thresh = threshold*corr*corr;
+
+      d_isps = (int)(sps + 0.5f);
+
+      if(d_engine == CORR_ENGINE_AUTO)
+        d_engine = corr_est_impl<gr_complex>::choose_engine(d_symbols.size(), max_latency);
+      if(d_engine == CORR_ENGINE_FFT) {
+        d_filter = new filter::kernel::fft_filter_ccc(1, d_symbols);
+        d_nsamples = d_filter->set_taps(d_symbols);
+      }
+      else
+        d_fir = new filter::kernel::fir_filter_ccc(1, d_symbols);
+
+      d_agc_hist.assign(d_agc_len, 0);
+
+      // corr_est_cc delays its output by the template length, and the
+      // first template's worth of it is the zeros in its history.
+      grow(d_symbols.size());
+      std::fill(d_z, d_z + d_symbols.size(), gr_complex(0));
+      d_z_end = d_symbols.size();
+    }
+
+    demod_frontend::~demod_frontend()
+    {
+      delete d_filter;
+      delete d_fir;
+      volk_free(d_z);
+      volk_free(d_corr);
+      volk_free(d_mag);
+    }
+
+    void
+    demod_frontend::push(const gr_complex *in, int nitems)
+    {
+      grow(nitems);
+      agc(in, nitems);
+      correlate();
+      find_peaks();
+    }
+
+    void
+    demod_frontend::grow(uint64_t nitems)
+    {
+      uint64_t len = d_z_end - d_base;
+      if(len + nitems <= d_cap)
+        return;
+
+      uint64_t size = 1;
+      while(size < len + nitems)
+        size <<= 1;
+
+      gr_complex *z = (gr_complex *)
+                      volk_malloc(sizeof(gr_complex)*size, volk_get_alignment());
+      gr_complex *corr = (gr_complex *)
+                         volk_malloc(sizeof(gr_complex)*size, volk_get_alignment());
+      float *mag = (float *)
+                   volk_malloc(sizeof(float)*size, volk_get_alignment());
+      if(d_z) {
+        uint64_t ncorr = d_corr_end - d_base;
+        memcpy(z, d_z, sizeof(gr_complex)*len);
+        memcpy(corr, d_corr, sizeof(gr_complex)*ncorr);
+        memcpy(mag, d_mag, sizeof(float)*ncorr);
+      }
+      volk_free(d_z);
+      volk_free(d_corr);
+      volk_free(d_mag);
+      d_z = z;
+      d_corr = corr;
+      d_mag = mag;
+      d_cap = size;
+    }
+
+    void
+    demod_frontend::trim(uint64_t pos)
+    {
+      // Keep what the timing loop (which can step back one sample on a
+      // reset), the correlator and the peak search will look at again.
+      uint64_t keep = pos > 0 ? pos - 1 : 0;
+      keep = std::min(keep, d_corr_end);
+      keep = std::min(keep, d_scan > 0 ? d_scan - 1 : 0);
+      keep = std::min(keep, d_z_end);
+      if(keep <= d_base)
+        return;
+
+      uint64_t shift = keep - d_base;
+      memmove(d_z, d_z + shift, sizeof(gr_complex)*(d_z_end - keep));
+      memmove(d_corr, d_corr + shift, sizeof(gr_complex)*(d_corr_end - keep));
+      memmove(d_mag, d_mag + shift, sizeof(float)*(d_corr_end - keep));
+      d_base = keep;
+    }
+
+    void
+    demod_frontend::agc(const gr_complex *in, int nitems)
+    {
+      // The same sliding-window peak normalization as
+      // feedforward_agc_cc(agc_len, agc_reference), including the zeros it
+      // starts with in its history, but tracking the window maximum with a
+      // monotonic queue rather than rescanning the window per sample.
+      gr_complex *z = d_z + (d_z_end - d_base);
+      for(int n = 0; n < nitems; n++, d_nin++) {
+        float max_env = std::max(1e-4f, d_env.push(envelope(in[n])));
+        float gain = d_agc_ref / max_env;
+        d_agc_hist[d_nin % d_agc_len] = in[n];
+        z[n] = gain * d_agc_hist[(d_nin + 1) % d_agc_len];
+      }
+      d_z_end += nitems;
+    }
+
+    void
+    demod_frontend::correlate()
+    {
+      // Correlator output j lines up with delayed sample j, and is the
+      // filter output on arrival of sample j + ntaps (see corr_est_cc).
+      const uint64_t ntaps = d_symbols.size();
+      if(d_z_end < d_corr_end + ntaps + 1)
+        return;
+      uint64_t n = d_z_end - d_corr_end - ntaps;
+
+      gr_complex *corr = d_corr + (d_corr_end - d_base);
+      if(d_filter) {
+        // The FFT kernel keeps its own tail; feed it whole blocks of the
+        // newest samples.
+        n -= n % d_nsamples;
+        if(n == 0)
+          return;
+        d_filter->filter(n, d_z + (d_corr_end + ntaps - d_base), corr);
+      }
+      else {
+        d_fir->filterN(corr, d_z + (d_corr_end + 1 - d_base), n);
+      }
+      volk_32fc_magnitude_squared_32f(d_mag + (d_corr_end - d_base), corr, n);
+      d_corr_end += n;
+    }
+
+    void
+    demod_frontend::find_peaks()
+    {
+      const float *mag = d_mag - d_base;
+      while(d_scan < d_corr_end) {
+        // Look for the correlator output to cross the threshold
+        if(mag[d_scan] <= d_thresh) {
+          d_scan++;
+          continue;
+        }
+        // Go to (just past) the current correlator output peak. Unlike a
+        // work() call we can always wait for the sample after the peak.
+        uint64_t i = d_scan;
+        while(i + 1 < d_corr_end && mag[i] < mag[i+1])
+          i++;
+        if(i + 1 >= d_corr_end)
+          break;
+
+        // Center of mass peak interpolation, as corr_est_cc
+        double center = 0.0;
+        if(i > 0) {
+          double nom = 0, den = 0;
+          for(int s = 0; s < 3; s++) {
+            nom += (s+1)*mag[i+s-1];
+            den += mag[i+s-1];
+          }
+          center = nom / den - 2.0;
+        }
+
+        // Per-burst carrier offset, as corr_est_cc; correlator output i
+        // lines up the preamble with z[i+1 ..]
+        const gr_complex *z = d_z - d_base;
+        float freq = 0;
+        if(d_freq_est)
+          freq = corr_est_impl<gr_complex>::estimate_freq(&z[i+1], d_symbols,
+                                                          d_fseg);
+
+        event ev = { i + d_mark_delay, (float) center, freq };
+        d_events.push_back(ev);
+        d_detections.fetch_add(1, std::memory_order_relaxed);
+
+        // Skip ahead to the next potential symbol peak
+        d_scan = i + d_isps;
+      }
+    }
+
+  } /* namespace ais */
+} /* namespace gr */
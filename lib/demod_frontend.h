@@ -0,0 +1,121 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIS_DEMOD_FRONTEND_H
+#define INCLUDED_AIS_DEMOD_FRONTEND_H
+
+#include <ais/corr_est_cc.h>
+#include "sliding_max.h"
+#include <gnuradio/filter/fft_filter.h>
+#include <gnuradio/filter/fir_filter.h>
+#include <atomic>
+#include <deque>
+
+namespace gr {
+  namespace ais {
+
+    /*!
+     * demod_cb's AGC and preamble correlator:
+     * feedforward_agc_cc followed by corr_est_cc, run over internal
+     * buffers. The AGC output, delayed as corr_est_cc delays it, is left
+     * for a timing loop to read, along with the timing marks found in it.
+     */
+    class demod_frontend
+    {
+    public:
+      struct event {
+        uint64_t offset; // timing mark, in correlator-delayed samples
+        float center;    // fractional timing estimate
+        float freq;      // carrier offset over the preamble, rad/sample,
+                         // with set_freq_estimate()
+      };
+
+      //! Longest AIS transmission: five slots of 256 bits
+      static const int MAX_BURST_SYMBOLS = 1280;
+
+      demod_frontend(const std::vector<gr_complex> &symbols,
+                     float sps, unsigned int mark_delay, float threshold,
+                     int agc_len, float agc_reference,
+                     corr_engine_type engine, unsigned int max_latency);
+      ~demod_frontend();
+
+      //! Run nitems more input through the AGC and correlator
+      void push(const gr_complex *in, int nitems);
+
+      //! Forget what a timing loop at \p pos won't look at again
+      void trim(uint64_t pos);
+
+      //! Delayed AGC output, indexed by absolute position
+      const gr_complex *samples() const { return d_z - d_base; }
+      //! One past the last sample available
+      uint64_t end() const { return d_z_end; }
+      //! Every timing mark before this position is already in events()
+      uint64_t marks_known() const { return d_scan + d_mark_delay; }
+      std::deque<event> &events() { return d_events; }
+
+      //! Input the correlator may hold back before anything comes out
+      unsigned int latency() const { return d_symbols.size() + d_nsamples + 2*d_isps; }
+      uint64_t detections() const { return d_detections; }
+
+      //! Fill in event::freq (left 0 otherwise)
+      void set_freq_estimate(bool enable) { d_freq_est = enable; }
+
+    private:
+      // correlator (see corr_est_cc)
+      std::vector<gr_complex> d_symbols;
+      unsigned int d_mark_delay;
+      float d_thresh;
+      int d_isps;
+      int d_fseg;
+      bool d_freq_est;
+      corr_engine_type d_engine;
+      filter::kernel::fft_filter_ccc *d_filter;
+      filter::kernel::fir_filter_ccc *d_fir;
+      int d_nsamples;
+      std::atomic<uint64_t> d_detections; // read from other threads
+
+      // AGC (see feedforward_agc_cc): the last agc_len input samples and
+      // the maximum of their envelopes
+      int d_agc_len;
+      float d_agc_ref;
+      std::vector<gr_complex> d_agc_hist;
+      sliding_max d_env;
+      uint64_t d_nin;
+
+      // Stage buffers, all indexed by absolute position in the AGC output
+      // delayed by the template length (i.e. corr_est_cc's output stream).
+      // Element 0 holds position d_base.
+      gr_complex *d_z;
+      gr_complex *d_corr;
+      float *d_mag;
+      uint64_t d_cap;
+      uint64_t d_base, d_z_end, d_corr_end, d_scan;
+      std::deque<event> d_events;
+
+      void grow(uint64_t nitems);
+      void agc(const gr_complex *in, int nitems);
+      void correlate();
+      void find_peaks();
+    };
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_AIS_DEMOD_FRONTEND_H */
@@ -0,0 +1,239 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+#include "energy_squelch_cc_impl.h"
+#include <volk/volk.h>
+#include <algorithm>
+#include <stdexcept>
+
+namespace gr {
+  namespace ais {
+
+    energy_squelch_cc::sptr
+    energy_squelch_cc::make(int block_len, float threshold_db, int preroll,
+                            int hangover)
+    {
+      return gnuradio::get_initial_sptr
+        (new energy_squelch_cc_impl(block_len, threshold_db, preroll,
+                                    hangover));
+    }
+
+    energy_squelch_cc_impl::energy_squelch_cc_impl(int block_len,
+                                                   float threshold_db,
+                                                   int preroll, int hangover)
+      : gr::block("energy_squelch_cc",
+                  gr::io_signature::make(1, 1, sizeof(gr_complex)),
+                  gr::io_signature::make(1, 1, sizeof(gr_complex))),
+        d_block_len(block_len),
+        d_hangover(hangover),
+        d_floor(0),
+        d_open(false),
+        d_hang(0),
+        d_gap(0),
+        d_dropped(0),
+        d_pre_head(0),
+        d_pre_count(0),
+        d_pending(0),
+        d_gap_key(pmt::intern("gap")),
+        d_src_id(pmt::intern(alias()))
+    {
+      if(block_len < 1) throw std::out_of_range("Block length must be positive");
+      if(preroll < 0 || hangover < 0)
+        throw std::out_of_range("Preroll and hangover must be nonnegative");
+      set_threshold(threshold_db);
+      d_pre.resize(preroll);
+      // Tags are moved by hand, to where their samples come out
+      set_tag_propagation_policy(TPP_DONT);
+    }
+
+    energy_squelch_cc_impl::~energy_squelch_cc_impl()
+    {
+    }
+
+    void
+    energy_squelch_cc_impl::set_threshold(float threshold_db)
+    {
+      if(threshold_db <= 0) throw std::out_of_range("Threshold must be positive");
+      d_threshold_db = threshold_db;
+      d_ratio = powf(10.0f, threshold_db/10.0f);
+    }
+
+    void
+    energy_squelch_cc_impl::forecast(int noutput_items,
+                                     gr_vector_int &ninput_items_required)
+    {
+      // A closed squelch eats input without producing anything, so the
+      // output space asked for says little about the input wanted.
+      ninput_items_required[0] = d_block_len;
+    }
+
+    // Mean power per sample of one block
+    float
+    energy_squelch_cc_impl::power(const gr_complex *in)
+    {
+      gr_complex acc;
+      volk_32fc_x2_conjugate_dot_prod_32fc(&acc, in, in, d_block_len);
+      return acc.real()/d_block_len;
+    }
+
+    // Keep the newest of the dropped samples for the next preroll
+    void
+    energy_squelch_cc_impl::remember(const gr_complex *in, int nitems)
+    {
+      const int size = d_pre.size();
+      if(size == 0)
+        return;
+      if(nitems > size) {
+        in += nitems - size;
+        nitems = size;
+      }
+      for(int k = 0; k < nitems; k++) {
+        d_pre[d_pre_head] = in[k];
+        if(++d_pre_head == size)
+          d_pre_head = 0;
+      }
+      d_pre_count = std::min(size, d_pre_count + nitems);
+    }
+
+    // Send out as much of the pending preroll as fits, oldest first
+    int
+    energy_squelch_cc_impl::flush(gr_complex *out, int nitems)
+    {
+      const int size = d_pre.size();
+      int n = std::min(nitems, d_pending);
+      int pos = d_pre_head - d_pending;
+      if(pos < 0)
+        pos += size;
+      for(int k = 0; k < n; k++) {
+        out[k] = d_pre[pos];
+        if(++pos == size)
+          pos = 0;
+      }
+      d_pending -= n;
+      return n;
+    }
+
+    // Hold the tags on a dropped block for the next sample out, keeping
+    // only the latest of each key
+    void
+    energy_squelch_cc_impl::hold_tags(uint64_t start)
+    {
+      get_tags_in_range(d_tags, 0, start, start + d_block_len);
+      for(size_t k = 0; k < d_tags.size(); k++) {
+        size_t j = 0;
+        while(j < d_held.size() && !pmt::eqv(d_held[j].key, d_tags[k].key))
+          j++;
+        if(j == d_held.size())
+          d_held.push_back(d_tags[k]);
+        else
+          d_held[j] = d_tags[k];
+      }
+    }
+
+    int
+    energy_squelch_cc_impl::general_work(int noutput_items,
+                                         gr_vector_int &ninput_items,
+                                         gr_vector_const_void_star &input_items,
+                                         gr_vector_void_star &output_items)
+    {
+      const gr_complex *in = (const gr_complex *) input_items[0];
+      gr_complex *out = (gr_complex *) output_items[0];
+      const int nin = ninput_items[0];
+      const float alpha = 0.1;
+
+      int i = 0, o = 0;
+      for(;;) {
+        // Finish the preroll of the last opening before anything else
+        if(d_pending > 0) {
+          o += flush(out + o, noutput_items - o);
+          if(d_pending > 0)
+            break;
+        }
+        if(i + d_block_len > nin)
+          break;
+        if(d_open && o + d_block_len > noutput_items)
+          break;
+
+        float p = power(in + i);
+        if(d_floor <= 0)
+          d_floor = p;
+        bool hot = p > d_ratio*d_floor;
+
+        if(!d_open) {
+          if(hot) {
+            // Open; the preroll goes out first, then this block on the
+            // next pass.
+            add_item_tag(0, nitems_written(0) + o, d_gap_key,
+                         pmt::from_uint64(d_gap - d_pre_count), d_src_id);
+            for(size_t k = 0; k < d_held.size(); k++)
+              add_item_tag(0, nitems_written(0) + o, d_held[k].key,
+                           d_held[k].value, d_held[k].srcid);
+            d_held.clear();
+            d_gap = 0;
+            d_pending = d_pre_count;
+            d_open = true;
+            d_hang = d_hangover;
+            continue;
+          }
+          // Quiet: follow the floor and drop the block
+          d_floor += alpha*(p - d_floor);
+          hold_tags(nitems_read(0) + i);
+          remember(in + i, d_block_len);
+          d_gap += d_block_len;
+          d_dropped += d_block_len;
+          i += d_block_len;
+          continue;
+        }
+
+        memcpy(out + o, in + i, sizeof(gr_complex)*d_block_len);
+        get_tags_in_range(d_tags, 0, nitems_read(0) + i,
+                          nitems_read(0) + i + d_block_len);
+        for(size_t k = 0; k < d_tags.size(); k++)
+          add_item_tag(0, d_tags[k].offset - nitems_read(0) - i
+                          + nitems_written(0) + o,
+                       d_tags[k].key, d_tags[k].value, d_tags[k].srcid);
+        o += d_block_len;
+        i += d_block_len;
+        // The floor holds still while open: even a slow leak of a long
+        // burst's power into it would close the squelch on the burst,
+        // and the hangover blocks still hold its tail
+        if(hot) {
+          d_hang = d_hangover;
+        }
+        else {
+          d_hang -= d_block_len;
+          if(d_hang <= 0) {
+            d_open = false;
+            d_pre_head = d_pre_count = 0;
+          }
+        }
+      }
+
+      consume_each(i);
+      return o;
+    }
+
+  } /* namespace ais */
+} /* namespace gr */
@@ -0,0 +1,80 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIS_ENERGY_SQUELCH_CC_IMPL_H
+#define INCLUDED_AIS_ENERGY_SQUELCH_CC_IMPL_H
+
+#include <ais/energy_squelch_cc.h>
+
+namespace gr {
+  namespace ais {
+
+    class energy_squelch_cc_impl : public energy_squelch_cc
+    {
+     private:
+      int d_block_len;
+      float d_threshold_db;
+      float d_ratio;
+      int d_hangover;
+      float d_floor;
+      bool d_open;
+      int d_hang;              // samples left before closing
+      uint64_t d_gap;          // dropped since the last output
+      uint64_t d_dropped;
+
+      // The last preroll samples dropped, as a ring, and how many of
+      // them are still to go out after an opening
+      std::vector<gr_complex> d_pre;
+      int d_pre_head, d_pre_count;
+      int d_pending;
+
+      const pmt::pmt_t d_gap_key;
+      const pmt::pmt_t d_src_id;
+      std::vector<tag_t> d_tags;
+      std::vector<tag_t> d_held;   // from dropped samples, for the next output
+
+      float power(const gr_complex *in);
+      void hold_tags(uint64_t start);
+      void remember(const gr_complex *in, int nitems);
+      int flush(gr_complex *out, int nitems);
+
+     public:
+      energy_squelch_cc_impl(int block_len, float threshold_db, int preroll,
+                             int hangover);
+      ~energy_squelch_cc_impl();
+
+      void set_threshold(float threshold_db);
+      float threshold() const { return d_threshold_db; }
+      float noise_floor() const { return d_floor; }
+      bool is_open() const { return d_open; }
+      uint64_t dropped() const { return d_dropped; }
+
+      void forecast(int noutput_items, gr_vector_int &ninput_items_required);
+
+      int general_work(int noutput_items,
+                       gr_vector_int &ninput_items,
+                       gr_vector_const_void_star &input_items,
+                       gr_vector_void_star &output_items);
+    };
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_AIS_ENERGY_SQUELCH_CC_IMPL_H */
@@ -23,28 +23,35 @@
 #endif
 
 #include <gnuradio/io_signature.h>
+#include <gnuradio/math.h>
 #include "freqest_impl.h"
+#include <volk/volk.h>
 
 namespace gr {
   namespace ais {
 
     freqest::sptr
-    freqest::make(float sample_rate, int data_rate, int fftlen)
+    freqest::make(float sample_rate, int data_rate, int fftlen,
+                  bool interpolate)
     {
       return gnuradio::get_initial_sptr
-        (new freqest_impl(sample_rate, data_rate, fftlen));
+        (new freqest_impl(sample_rate, data_rate, fftlen, interpolate));
     }
 
     /*
      * The private constructor
      */
-    freqest_impl::freqest_impl(float sample_rate, int data_rate, int fftlen)
+    freqest_impl::freqest_impl(float sample_rate, int data_rate, int fftlen,
+                               bool interpolate)
       : gr::sync_block("freqest",
               gr::io_signature::make(1, 1, sizeof(gr_complex) * fftlen),
-              gr::io_signature::make(1, 1, sizeof(float)))
+              gr::io_signature::make(1, 1, sizeof(float))),
+        d_interpolate(interpolate)
     {
         d_offset = fftlen * (float(data_rate) / float(sample_rate));
         d_binsize = float(sample_rate) / float(fftlen);
+        d_mag = (float *) volk_malloc(sizeof(float)*fftlen, volk_get_alignment());
+        d_sum = (float *) volk_malloc(sizeof(float)*fftlen, volk_get_alignment());
     }
 
     /*
@@ -52,6 +59,45 @@ namespace gr {
      */
     freqest_impl::~freqest_impl()
     {
+        volk_free(d_mag);
+        volk_free(d_sum);
+    }
+
+    /*
+     * Find the frequency offset from one FFT of the squared signal. MSK
+     * squared has two tones at +/- datarate/2 around twice the carrier
+     * offset; we look for the pair of bins offset apart with the most
+     * energy. Shared with square_and_fft_sync_cc so the two agree exactly.
+     * mag and sum are caller-owned scratch of at least fftlen floats.
+     */
+    float
+    freqest_impl::estimate(const gr_complex *in, float *mag, float *sum,
+                           unsigned int fftlen, int offset, float binsize,
+                           bool interpolate)
+    {
+        //magnitude of each bin, once
+        volk_32fc_magnitude_32f(mag, in, fftlen);
+
+        //sum of the two bins at -datarate/2 and +datarate/2, over the entire
+        //fft up until the right side of the "window" butts up against the end
+        const unsigned int npairs = fftlen - offset;
+        volk_32f_x2_add_32f(sum, mag, &mag[offset], npairs);
+
+        uint32_t peak = 0;
+        volk_32f_index_max_32u(&peak, sum, npairs);
+
+        float center = peak + offset/2; //add the offset to find the center position
+        if(interpolate and peak > 0 and peak < npairs-1) {
+            //fit a parabola through the peak and its neighbours; with a
+            //sub-bin answer, an odd offset's half bin counts too
+            float den = sum[peak-1] - 2*sum[peak] + sum[peak+1];
+            if(den < 0) {
+                float delta = 0.5f * (sum[peak-1] - sum[peak+1]) / den;
+                center = peak + 0.5f*offset + gr::branchless_clip(delta, 0.5f);
+            }
+        }
+        //now center is the center bin, and we must translate that to a frequency offset
+        return (center - fftlen/2) * binsize/2; //subtract fftlen/2 to center the complex FFT around 0
     }
 
     int
@@ -64,24 +110,11 @@ namespace gr {
 
         unsigned int fftlen = input_signature()->sizeof_stream_item(0) / sizeof(gr_complex);
 
-        float maxenergy = 0;
-        unsigned int maxpos = 0;
-        float currentenergy;
-
         //you are responsible for organizing the vector
         for (int i = 0; i < noutput_items; i++) {
             //for each requested output item
-            maxenergy = 0;
-            for(unsigned int j = 0; j < fftlen - d_offset; j++) {
-                //over the entire fft up until the right side of the "window" butts up against the end
-                currentenergy = std::abs(in[i*fftlen+j]) + std::abs(in[i*fftlen+j+d_offset]); //sum of the two bins at -datarate/2 and +datarate/2
-                if(currentenergy > maxenergy) {
-                    maxenergy = currentenergy;
-                    maxpos = j + d_offset/2; //add the offset to find the center position
-                }
-            }
-            //now maxpos contains the center bin, and we must translate that to a frequency offset
-            out[i] = (float(maxpos) - fftlen/2) * d_binsize/2; //subtract fftlen/2 to center the complex FFT around 0
+            out[i] = estimate(&in[i*fftlen], d_mag, d_sum, fftlen,
+                              d_offset, d_binsize, d_interpolate);
         }
 
         return noutput_items;
@@ -31,11 +31,19 @@ namespace gr {
      private:
      float d_binsize;
      int d_offset;
+     bool d_interpolate;
+     float *d_mag;
+     float *d_sum;
 
      public:
-      freqest_impl(float sample_rate, int data_rate, int fftlen);
+      freqest_impl(float sample_rate, int data_rate, int fftlen,
+                   bool interpolate);
       ~freqest_impl();
 
+      static float estimate(const gr_complex *in, float *mag, float *sum,
+                            unsigned int fftlen, int offset, float binsize,
+                            bool interpolate);
+
       int work(int noutput_items,
 		       gr_vector_const_void_star &input_items,
 		       gr_vector_void_star &output_items);
@@ -0,0 +1,284 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+#include <gnuradio/math.h>
+#include <gnuradio/expj.h>
+#include "gmsk_viterbi_cb_impl.h"
+#include <ais/corr_detection.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace gr {
+  namespace ais {
+
+    gmsk_viterbi_cb::sptr
+    gmsk_viterbi_cb::make(float bt, float sample_offset, int traceback,
+                          float loop_gain)
+    {
+      return gnuradio::get_initial_sptr
+        (new gmsk_viterbi_cb_impl(bt, sample_offset, traceback, loop_gain));
+    }
+
+    gmsk_viterbi_cb_impl::gmsk_viterbi_cb_impl(float bt, float sample_offset,
+                                               int traceback, float loop_gain)
+      : gr::block("gmsk_viterbi_cb",
+                  gr::io_signature::make(1, 1, sizeof(gr_complex)),
+                  gr::io_signature::make(1, 1, sizeof(char))),
+        d_best(0),
+        d_traceback(traceback),
+        d_ndec(0),
+        d_last(0),
+        d_phase(0),
+        d_freq(0),
+        d_resets(0),
+        d_phase_est_key(pmt::intern("phase_est")),
+        d_corr_det_key(pmt::intern("corr_det"))
+    {
+      if(bt <= 0) throw std::out_of_range("BT must be positive");
+      if(fabsf(sample_offset) > 0.5f)
+        throw std::out_of_range("Sample offset must be within half a symbol");
+      if(traceback < 1) throw std::out_of_range("Traceback must be positive");
+      set_loop_gain(loop_gain);
+
+      // Phase at the sample, in pi/2, relative to the state's
+      // accumulated phase: the previous symbol is all but done, the
+      // current one part way, and the next just starting.
+      const double qprev = phase_pulse(bt, sample_offset + 1) - 1;
+      const double qcur = phase_pulse(bt, sample_offset);
+      const double qnext = phase_pulse(bt, sample_offset - 1);
+      for(int g = 0; g < NGROUPS; g++) {
+        // Group g is the successors' accumulated phase and current
+        // symbol; the predecessors' phase is one symbol less.
+        const double cur = (g & 1) ? 1 : -1;
+        const double acc = (g >> 1) - cur;
+        for(int half = 0; half < 2; half++) {
+          for(int b = 0; b < 2; b++) {
+            double ph = M_PI/2*(acc + (half ? 1 : -1)*qprev + cur*qcur
+                                + (b ? 1 : -1)*qnext);
+            d_exp_re[half*2 + b][g] = cos(ph);
+            d_exp_im[half*2 + b][g] = sin(ph);
+          }
+        }
+        for(int b = 0; b < 2; b++) {
+          int p = (g & 1)*NGROUPS + ((((g >> 1) + (b ? 1 : 3)) & 3) << 1) + b;
+          d_next[b][g] = p;
+          d_from_group[p] = g;
+          d_from_bit[p] = b;
+        }
+      }
+
+      d_dec.resize(2*traceback);
+      d_sym.resize(2*traceback);
+      reset(0);
+      d_resets = 0;
+
+      // Room for the most one input sample can release
+      set_output_multiple(2*traceback);
+      set_tag_propagation_policy(TPP_DONT);
+    }
+
+    gmsk_viterbi_cb_impl::~gmsk_viterbi_cb_impl()
+    {
+    }
+
+    void
+    gmsk_viterbi_cb_impl::set_loop_gain(float loop_gain)
+    {
+      if(loop_gain < 0 || loop_gain >= 1)
+        throw std::out_of_range("Loop gain must be in [0, 1)");
+      d_loop_gain = loop_gain;
+    }
+
+    // The Gaussian-filtered frequency pulse integrated from its start to
+    // t symbols from its centre, truncated to three symbols and scaled to
+    // end at 1
+    double
+    gmsk_viterbi_cb_impl::phase_pulse(double bt, double t)
+    {
+      const double k = 2*M_PI*bt/sqrt(log(2.0))/M_SQRT2;
+      const int steps = 256;
+      double total = 0, part = 0;
+      for(int i = 0; i < 3*steps; i++) {
+        double u = -1.5 + (i + 0.5)/steps;
+        double g = erfc(k*(u - 0.5)) - erfc(k*(u + 0.5));
+        total += g;
+        if(u < t)
+          part += g;
+      }
+      return part/total;
+    }
+
+    void
+    gmsk_viterbi_cb_impl::reset(float phase)
+    {
+      std::fill(d_metric, d_metric + NSTATES, 0.0f);
+      d_best = 0;
+      d_phase = -phase;
+      d_freq = 0;
+      d_resets++;
+    }
+
+    void
+    gmsk_viterbi_cb_impl::step(gr_complex x)
+    {
+      const gr_complex r = x*gr_expj(d_phase);
+      const float re = r.real(), im = r.imag();
+
+      float bm[4][NGROUPS];
+      for(int k = 0; k < 4; k++)
+        for(int g = 0; g < NGROUPS; g++)
+          bm[k][g] = re*d_exp_re[k][g] + im*d_exp_im[k][g];
+
+      // Add-compare-select, a group per lane: the predecessor in the
+      // lower half has the previous symbol 0, the upper 1
+      float next[2][NGROUPS];
+      int pick[2][NGROUPS];
+      for(int b = 0; b < 2; b++) {
+        for(int g = 0; g < NGROUPS; g++) {
+          float m0 = d_metric[g] + bm[b][g];
+          float m1 = d_metric[NGROUPS + g] + bm[2 + b][g];
+          pick[b][g] = m1 > m0;
+          next[b][g] = std::max(m0, m1);
+        }
+      }
+
+      // Into the next step's order, relative to the best
+      uint16_t dec = 0;
+      float best = next[0][0];
+      int bestpos = d_next[0][0];
+      for(int b = 0; b < 2; b++) {
+        for(int g = 0; g < NGROUPS; g++) {
+          int p = d_next[b][g];
+          d_metric[p] = next[b][g];
+          dec |= pick[b][g] << p;
+          if(next[b][g] > best) {
+            best = next[b][g];
+            bestpos = p;
+          }
+        }
+      }
+      for(int p = 0; p < NSTATES; p++)
+        d_metric[p] -= best;
+      d_dec[d_ndec++] = dec;
+      d_best = bestpos;
+
+      // Track the carrier against the best branch
+      if(d_loop_gain > 0) {
+        int k = ((dec >> bestpos) & 1)*2 + d_from_bit[bestpos];
+        int g = d_from_group[bestpos];
+        gr_complex z = r*gr_complex(d_exp_re[k][g], -d_exp_im[k][g]);
+        float err = gr::fast_atan2f(z.imag(), z.real());
+        d_freq = gr::branchless_clip(d_freq - d_loop_gain*d_loop_gain*0.25f*err, 0.5f);
+        d_phase -= d_loop_gain*err;
+      }
+      d_phase += d_freq;
+      if(d_phase > M_PI)
+        d_phase -= 2*M_PI;
+      else if(d_phase < -M_PI)
+        d_phase += 2*M_PI;
+    }
+
+    // Trace back from the best state through the decisions held and put
+    // out the bits of all but the newest keep steps
+    int
+    gmsk_viterbi_cb_impl::trace(int keep, uint8_t *out)
+    {
+      int pos = d_best;
+      for(int t = d_ndec - 1; t >= 0; t--) {
+        d_sym[t] = d_from_bit[pos];
+        pos = ((d_dec[t] >> pos) & 1)*NGROUPS + d_from_group[pos];
+      }
+      const int n = d_ndec - keep;
+      for(int t = 0; t < n; t++) {
+        out[t] = d_sym[t] == d_last;  //NRZI: no transition is a one
+        d_last = d_sym[t];
+      }
+      std::copy(d_dec.begin() + n, d_dec.begin() + d_ndec, d_dec.begin());
+      d_ndec = keep;
+      return n;
+    }
+
+    void
+    gmsk_viterbi_cb_impl::forecast(int noutput_items,
+                                   gr_vector_int &ninput_items_required)
+    {
+      ninput_items_required[0] = noutput_items;
+    }
+
+    int
+    gmsk_viterbi_cb_impl::general_work(int noutput_items,
+                                       gr_vector_int &ninput_items,
+                                       gr_vector_const_void_star &input_items,
+                                       gr_vector_void_star &output_items)
+    {
+      const gr_complex *in = (const gr_complex *) input_items[0];
+      uint8_t *out = (uint8_t *) output_items[0];
+      const int ninp = ninput_items[0];
+      const uint64_t nread = nitems_read(0);
+
+      // Burst starts, as plain phase_est tags or corr_est's records
+      std::vector<tag_t> all_tags, tags;
+      get_tags_in_range(all_tags, 0, nread, nread + ninp);
+      for(size_t t = 0; t < all_tags.size(); t++) {
+        if(pmt::eq(all_tags[t].key, d_phase_est_key)
+           || pmt::eq(all_tags[t].key, d_corr_det_key))
+          tags.push_back(all_tags[t]);
+      }
+      std::stable_sort(tags.begin(), tags.end(),
+                       [](const tag_t &a, const tag_t &b) { return a.offset < b.offset; });
+
+      int i = 0, o = 0;
+      size_t t = 0;
+      while(i < ninp && o + 2*d_traceback <= noutput_items) {
+        bool started = false;
+        for(; t < tags.size() && tags[t].offset == nread + i; t++) {
+          if(started)  //a record and a plain tag for the same burst
+            continue;
+          float phase;
+          corr_detection det;
+          if(pmt::eq(tags[t].key, d_corr_det_key)) {
+            if(!corr_detection_from_pmt(tags[t].value, det))
+              continue;
+            phase = det.phase_est;
+          }
+          else phase = (float) pmt::to_double(tags[t].value);
+          if(phase != phase) //NaN
+            continue;
+          o += trace(0, out + o);
+          reset(phase);
+          started = true;
+        }
+        step(in[i++]);
+        if(d_ndec == 2*d_traceback)
+          o += trace(d_traceback, out + o);
+      }
+
+      consume_each(i);
+      return o;
+    }
+
+  } /* namespace ais */
+} /* namespace gr */
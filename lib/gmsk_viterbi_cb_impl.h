@@ -0,0 +1,94 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIS_GMSK_VITERBI_CB_IMPL_H
+#define INCLUDED_AIS_GMSK_VITERBI_CB_IMPL_H
+
+#include <ais/gmsk_viterbi_cb.h>
+
+namespace gr {
+  namespace ais {
+
+    class gmsk_viterbi_cb_impl : public gmsk_viterbi_cb
+    {
+     private:
+      // A state is the phase accumulated before the current symbol
+      // (0-3, in pi/2), the previous symbol and the current one. States
+      // are kept in the order the add-compare-select reads them: the two
+      // with the same successors, differing only in the previous symbol,
+      // are the same group in either half of the array.
+      static const int NSTATES = 16;
+      static const int NGROUPS = 8;
+
+      // Expected samples as unit phasors for each branch, by the half
+      // the predecessor is in, the new symbol, and the group
+      float d_exp_re[4][NGROUPS];
+      float d_exp_im[4][NGROUPS];
+      // Where successor b of group g goes in the next step's order, and
+      // back again
+      int d_next[2][NGROUPS];
+      int d_from_group[NSTATES];
+      int d_from_bit[NSTATES];
+
+      float d_metric[NSTATES];
+      int d_best;
+      int d_traceback;
+      // Decisions since the last output: bit p of each is which half
+      // the winning predecessor of the state at p came from
+      std::vector<uint16_t> d_dec;
+      int d_ndec;
+      std::vector<uint8_t> d_sym;
+      uint8_t d_last;
+
+      // Carrier: the derotation in radians and its rate per symbol
+      float d_loop_gain;
+      float d_phase;
+      float d_freq;
+      uint64_t d_resets;
+
+      const pmt::pmt_t d_phase_est_key;
+      const pmt::pmt_t d_corr_det_key;
+
+      static double phase_pulse(double bt, double t);
+      void reset(float phase);
+      void step(gr_complex x);
+      int trace(int keep, uint8_t *out);
+
+     public:
+      gmsk_viterbi_cb_impl(float bt, float sample_offset, int traceback,
+                           float loop_gain);
+      ~gmsk_viterbi_cb_impl();
+
+      void set_loop_gain(float loop_gain);
+      float loop_gain() const { return d_loop_gain; }
+      uint64_t resets() const { return d_resets; }
+
+      void forecast(int noutput_items, gr_vector_int &ninput_items_required);
+
+      int general_work(int noutput_items,
+                       gr_vector_int &ninput_items,
+                       gr_vector_const_void_star &input_items,
+                       gr_vector_void_star &output_items);
+    };
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_AIS_GMSK_VITERBI_CB_IMPL_H */
@@ -0,0 +1,401 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+#include "hdlc_deframer_bp_impl.h"
+#include <climits>
+
+namespace gr {
+  namespace ais {
+
+    namespace {
+      struct unstuff_entry {
+        uint8_t bits;    // data bits left, first bit in the LSB
+        uint8_t nbits;   // how many
+        uint8_t ones;    // run of ones carried out
+        uint8_t special; // would complete six ones; do it bit by bit
+        uint8_t keep;    // input bits that are data, bit p for the p-th in
+      };
+
+      struct deframer_tables {
+        // Indexed by the run of ones carried in (0-5) and the input byte
+        unstuff_entry unstuff[6][256];
+        // CRC-16/X.25 (reflected 0x1021) for slicing-by-8: crc[n][b] is the
+        // register after byte b followed by n zero bytes.
+        uint16_t crc[8][256];
+
+        deframer_tables()
+        {
+          for(int s = 0; s < 6; s++) {
+            for(int b = 0; b < 256; b++) {
+              unstuff_entry &e = unstuff[s][b];
+              int ones = s, n = 0;
+              unsigned int bits = 0, keep = 0;
+              e.special = 0;
+              for(int k = 7; k >= 0; k--) {
+                if((b >> k) & 1) {
+                  if(++ones >= 6) {
+                    e.special = 1;
+                    break;
+                  }
+                  keep |= 1 << (7-k);
+                  bits |= 1 << n++;
+                }
+                else {
+                  if(ones != 5) { //otherwise a stuffed zero
+                    keep |= 1 << (7-k);
+                    n++;
+                  }
+                  ones = 0;
+                }
+              }
+              e.keep = keep;
+              e.bits = bits;
+              e.nbits = n;
+              e.ones = ones;
+            }
+          }
+
+          for(int b = 0; b < 256; b++) {
+            uint16_t c = b;
+            for(int k = 0; k < 8; k++)
+              c = (c & 1) ? (c >> 1) ^ 0x8408 : (c >> 1);
+            crc[0][b] = c;
+          }
+          for(int n = 1; n < 8; n++)
+            for(int b = 0; b < 256; b++)
+              crc[n][b] = (crc[n-1][b] >> 8) ^ crc[0][crc[n-1][b] & 0xFF];
+        }
+      };
+
+      const deframer_tables &
+      tables()
+      {
+        static const deframer_tables t;
+        return t;
+      }
+
+      uint16_t
+      crc16_x25(const uint8_t *p, size_t len)
+      {
+        const uint16_t (*t)[256] = tables().crc;
+        uint32_t crc = 0xFFFF;
+        for(; len >= 8; p += 8, len -= 8) {
+          uint32_t one = (p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24)) ^ crc;
+          uint32_t two = p[4] | (p[5] << 8) | (p[6] << 16) | ((uint32_t) p[7] << 24);
+          crc = t[7][one & 0xFF] ^ t[6][(one >> 8) & 0xFF]
+              ^ t[5][(one >> 16) & 0xFF] ^ t[4][one >> 24]
+              ^ t[3][two & 0xFF] ^ t[2][(two >> 8) & 0xFF]
+              ^ t[1][(two >> 16) & 0xFF] ^ t[0][two >> 24];
+        }
+        while(len--)
+          crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+        return crc ^ 0xFFFF;
+      }
+    }
+
+    hdlc_deframer_bp::sptr
+    hdlc_deframer_bp::make(int length_min, int length_max, bool nrzi,
+                           int flip_bits, int conf_floor)
+    {
+      return gnuradio::get_initial_sptr
+        (new hdlc_deframer_bp_impl(length_min, length_max, nrzi, flip_bits,
+                                   conf_floor));
+    }
+
+    hdlc_deframer_bp_impl::hdlc_deframer_bp_impl(int length_min,
+                                                 int length_max, bool nrzi,
+                                                 int flip_bits, int conf_floor)
+      : gr::sync_block("hdlc_deframer_bp",
+                       gr::io_signature::make2(1, 2, sizeof(char), 8*sizeof(char)),
+                       gr::io_signature::make(0, 0, 0)),
+        d_length_min(length_min),
+        d_length_max(length_max),
+        d_nrzi(nrzi),
+        d_nrzi_last(0),
+        d_ones(0),
+        d_in_frame(false),
+        d_acc(0),
+        d_accn(0),
+        d_len(0),
+        d_soft(false),
+        d_recovered(0),
+        d_out_port(pmt::mp("out")),
+        d_offset_key(pmt::mp("offset")),
+        d_flipped_key(pmt::mp("flipped"))
+    {
+      if(length_min < 0 || length_max < length_min)
+        throw std::out_of_range("Frame lengths must satisfy 0 <= min <= max");
+      set_flip_bits(flip_bits);
+      set_conf_floor(conf_floor);
+      // room for the FCS too, and for the confidences of the byte that
+      // overflows it
+      d_pkt.resize(length_max + 2);
+      d_conf.resize(8*(length_max + 4));
+      tables();
+      message_port_register_out(d_out_port);
+    }
+
+    hdlc_deframer_bp_impl::~hdlc_deframer_bp_impl()
+    {
+    }
+
+    void
+    hdlc_deframer_bp_impl::set_flip_bits(int flip_bits)
+    {
+      if(flip_bits < 0 || flip_bits > MAX_FLIP_BITS)
+        throw std::out_of_range("flip_bits must be between 0 and 8");
+      d_flip_bits = flip_bits;
+    }
+
+    void
+    hdlc_deframer_bp_impl::set_conf_floor(int conf_floor)
+    {
+      if(conf_floor < 0 || conf_floor > 256)
+        throw std::out_of_range("conf_floor must be between 0 and 256");
+      d_conf_floor = conf_floor;
+    }
+
+    inline void
+    hdlc_deframer_bp_impl::store(uint32_t bits, int nbits)
+    {
+      d_acc |= bits << d_accn;
+      d_accn += nbits;
+      while(d_accn >= 8) {
+        if(d_len == (int) d_pkt.size()) { //too long for AIS, go back to hunting
+          d_in_frame = false;
+          return;
+        }
+        d_pkt[d_len++] = d_acc & 0xFF;
+        d_acc >>= 8;
+        d_accn -= 8;
+      }
+    }
+
+    // The confidences of the bits of one input byte that store() is
+    // about to take as data, as picked out by an unstuff_entry's keep
+    inline void
+    hdlc_deframer_bp_impl::store_conf(const uint8_t *conf, unsigned int keep)
+    {
+      int pos = 8*d_len + d_accn;
+      for(int p = 0; p < 8; p++)
+        if((keep >> p) & 1)
+          d_conf[pos++] = conf[p];
+    }
+
+    inline void
+    hdlc_deframer_bp_impl::bit(unsigned int b, uint8_t conf, uint64_t offset)
+    {
+      if(b) {
+        if(d_ones < 7) d_ones++;
+        if(d_ones == 7) d_in_frame = false; //abort
+        else if(d_ones < 6 && d_in_frame) {
+          d_conf[8*d_len + d_accn] = conf;
+          store(1, 1);
+        }
+        return;
+      }
+      if(d_ones == 6) { //flag
+        if(d_in_frame) end_frame(offset);
+        d_in_frame = true;
+        d_len = 0;
+        d_acc = 0;
+        d_accn = 0;
+      }
+      else if(d_ones < 5 && d_in_frame) {
+        d_conf[8*d_len + d_accn] = conf;
+        store(0, 1);
+      }
+      d_ones = 0;
+    }
+
+    void
+    hdlc_deframer_bp_impl::end_frame(uint64_t offset)
+    {
+      // The flag's leading zero and five ones went in as data before we
+      // knew it was a flag, so a whole number of bytes leaves exactly six
+      // bits over.
+      if(d_accn != 6)
+        return;
+      int len = d_len - 2;
+      if(len < d_length_min || len > d_length_max)
+        return;
+      uint16_t fcs = d_pkt[len] | (d_pkt[len+1] << 8);
+      int flipped = 0;
+      if(crc16_x25(&d_pkt[0], len) != fcs) {
+        if(!d_soft || d_flip_bits == 0 || (flipped = recover(len)) == 0)
+          return;
+        d_recovered++;
+      }
+
+      pmt::pmt_t meta = pmt::make_dict();
+      meta = pmt::dict_add(meta, d_offset_key, pmt::from_uint64(offset));
+      if(flipped)
+        meta = pmt::dict_add(meta, d_flipped_key, pmt::from_long(flipped));
+      message_port_pub(d_out_port,
+                       pmt::cons(meta, pmt::init_u8vector(len, &d_pkt[0])));
+    }
+
+    // Find the cheapest combination of flips of the doubtful bits of a
+    // len byte frame (and its FCS) that makes the CRC check, apply it to
+    // d_pkt and return the number of flips, or 0 if there is none or if
+    // there are more than d_flip_bits doubtful bits to choose from.
+    int
+    hdlc_deframer_bp_impl::recover(int len)
+    {
+      const int nbits = 8*(len + 2);
+      const uint8_t *conf = &d_conf[0];
+
+      // A frame with many doubtful bits is too far gone to trust to a
+      // few flips, or wasn't a frame at all
+      d_order.clear();
+      for(int p = 0; p < nbits; p++) {
+        if(conf[p] < d_conf_floor) {
+          if((int) d_order.size() == d_flip_bits)
+            return 0;
+          d_order.push_back(p);
+        }
+      }
+      const int k = d_order.size();
+      if(k == 0)
+        return 0;
+
+      // Flipping data bit p changes the CRC by what a lone one at p leaves
+      // in a zeroed register: the register after the last bit, stepped on
+      // by a zero for each bit after p. Flipping FCS bit j changes the
+      // received FCS by bit j.
+      d_synd.resize(nbits);
+      uint16_t r = 0x8408;
+      for(int p = 8*len - 1; p >= 0; p--) {
+        d_synd[p] = r;
+        r = (r & 1) ? (r >> 1) ^ 0x8408 : (r >> 1);
+      }
+      for(int j = 0; j < 16; j++)
+        d_synd[8*len + j] = 1 << j;
+
+      // Under NRZI one wrong channel bit inverts its decoded bit and the
+      // next
+      uint16_t delta[MAX_FLIP_BITS];
+      int cost[MAX_FLIP_BITS];
+      for(int h = 0; h < k; h++) {
+        int p = d_order[h];
+        delta[h] = d_synd[p];
+        if(d_nrzi && p + 1 < nbits)
+          delta[h] ^= d_synd[p+1];
+        cost[h] = conf[p];
+      }
+
+      // Gray code order: one flip in or out per combination
+      const uint16_t target = crc16_x25(&d_pkt[0], len)
+                            ^ (d_pkt[len] | (d_pkt[len+1] << 8));
+      uint16_t synd = 0;
+      unsigned int set = 0, best = 0;
+      int c = 0, best_cost = INT_MAX;
+      for(unsigned int g = 1; g < (1u << k); g++) {
+        int h = __builtin_ctz(g);
+        set ^= 1u << h;
+        synd ^= delta[h];
+        c += ((set >> h) & 1) ? cost[h] : -cost[h];
+        if(synd == target && c < best_cost) {
+          best = set;
+          best_cost = c;
+        }
+      }
+      if(!best)
+        return 0;
+
+      for(int h = 0; h < k; h++) {
+        if(!((best >> h) & 1))
+          continue;
+        int p = d_order[h];
+        d_pkt[p >> 3] ^= 1 << (p & 7);
+        if(d_nrzi && p + 1 < nbits)
+          d_pkt[(p+1) >> 3] ^= 1 << ((p+1) & 7);
+      }
+      return __builtin_popcount(best);
+    }
+
+    int
+    hdlc_deframer_bp_impl::work(int noutput_items,
+                                gr_vector_const_void_star &input_items,
+                                gr_vector_void_star &output_items)
+    {
+      const uint8_t *in = (const uint8_t *) input_items[0];
+      d_soft = input_items.size() > 1;
+      const uint8_t *soft = d_soft ? (const uint8_t *) input_items[1] : NULL;
+      const deframer_tables &t = tables();
+      const uint64_t nread = nitems_read(0);
+
+      if(d_nrzi) {
+        // Each bit against the one before it, a byte at a time
+        d_nrzi_buf.resize(noutput_items);
+        for(int i = 0; i < noutput_items; i++) {
+          uint8_t prev = (in[i] >> 1) | (d_nrzi_last << 7);
+          d_nrzi_buf[i] = ~(in[i] ^ prev);
+          d_nrzi_last = in[i] & 1;
+        }
+        in = &d_nrzi_buf[0];
+      }
+
+      int i = 0;
+      while(i < noutput_items) {
+        // Between frames, skip eight bytes at a time while they can't hold
+        // a run of six ones (so no flag can start or end in them).
+        if(!d_in_frame && i + 8 <= noutput_items) {
+          uint64_t w = 0;
+          for(int k = 0; k < 8; k++)
+            w = (w << 8) | in[i+k];
+          uint64_t run = w & (w << 1) & (w << 2) & (w << 3) & (w << 4) & (w << 5);
+          if(run == 0 && d_ones + __builtin_clzll(~w) < 6) {
+            d_ones = __builtin_ctzll(~w);
+            i += 8;
+            continue;
+          }
+        }
+
+        // Otherwise a byte at a time, unless it finishes a run of six
+        // ones, when it goes through the bit-level state machine.
+        uint8_t b = in[i];
+        if(d_ones < 6) {
+          const unstuff_entry &e = t.unstuff[d_ones][b];
+          if(!e.special) {
+            if(d_in_frame) {
+              if(d_soft) store_conf(&soft[8*i], e.keep);
+              store(e.bits, e.nbits);
+            }
+            d_ones = e.ones;
+            i++;
+            continue;
+          }
+        }
+        for(int k = 7; k >= 0; k--)
+          bit((b >> k) & 1, d_soft ? soft[8*i + 7-k] : 0, nread + i);
+        i++;
+      }
+
+      return noutput_items;
+    }
+
+  } /* namespace ais */
+} /* namespace gr */
@@ -0,0 +1,88 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIS_HDLC_DEFRAMER_BP_IMPL_H
+#define INCLUDED_AIS_HDLC_DEFRAMER_BP_IMPL_H
+
+#include <ais/hdlc_deframer_bp.h>
+
+namespace gr {
+  namespace ais {
+
+    class hdlc_deframer_bp_impl : public hdlc_deframer_bp
+    {
+     private:
+      static const int MAX_FLIP_BITS = 8;
+
+      int d_length_min;
+      int d_length_max;
+      bool d_nrzi;
+      uint8_t d_nrzi_last;
+      std::vector<uint8_t> d_nrzi_buf;
+
+      // bit-level deframer state
+      int d_ones;            // consecutive ones seen
+      bool d_in_frame;
+      uint32_t d_acc;        // partial byte, first bit in the LSB
+      int d_accn;            // bits in d_acc
+      std::vector<uint8_t> d_pkt;
+      int d_len;             // complete bytes in d_pkt
+
+      // bit-flip recovery: the confidence of each bit stored in d_pkt,
+      // in the same order (first bit of d_pkt[0] first), and scratch
+      int d_flip_bits;
+      int d_conf_floor;
+      bool d_soft;           // confidences are coming in this call
+      uint64_t d_recovered;
+      std::vector<uint8_t> d_conf;
+      std::vector<int> d_order;
+      std::vector<uint16_t> d_synd;
+
+      const pmt::pmt_t d_out_port;
+      const pmt::pmt_t d_offset_key;
+      const pmt::pmt_t d_flipped_key;
+
+      inline void store(uint32_t bits, int nbits);
+      inline void store_conf(const uint8_t *conf, unsigned int keep);
+      inline void bit(unsigned int b, uint8_t conf, uint64_t offset);
+      void end_frame(uint64_t offset);
+      int recover(int len);
+
+     public:
+      hdlc_deframer_bp_impl(int length_min, int length_max, bool nrzi,
+                            int flip_bits, int conf_floor);
+      ~hdlc_deframer_bp_impl();
+
+      void set_flip_bits(int flip_bits);
+      int flip_bits() const { return d_flip_bits; }
+
+      void set_conf_floor(int conf_floor);
+      int conf_floor() const { return d_conf_floor; }
+      uint64_t recovered() const { return d_recovered; }
+
+      int work(int noutput_items,
+               gr_vector_const_void_star &input_items,
+               gr_vector_void_star &output_items);
+    };
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_AIS_HDLC_DEFRAMER_BP_IMPL_H */
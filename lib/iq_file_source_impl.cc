@@ -0,0 +1,262 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+#include "iq_file_source_impl.h"
+#include <volk/volk.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace gr {
+  namespace ais {
+
+    static bool
+    ends_with(const std::string &s, const std::string &suffix)
+    {
+      return s.size() >= suffix.size()
+        && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    static bool
+    file_exists(const std::string &name)
+    {
+      struct stat st;
+      return stat(name.c_str(), &st) == 0;
+    }
+
+    // Where the value of "key" starts in a JSON text, or npos. SigMF
+    // metadata only needs a handful of scalar fields, and the first
+    // occurrence of each is the one wanted (global, then first capture).
+    static size_t
+    json_value(const std::string &text, const std::string &key)
+    {
+      size_t pos = text.find("\"" + key + "\"");
+      if(pos == std::string::npos)
+        return pos;
+      pos = text.find(':', pos + key.size() + 2);
+      if(pos == std::string::npos)
+        return pos;
+      return text.find_first_not_of(" \t\r\n", pos + 1);
+    }
+
+    iq_file_source::sptr
+    iq_file_source::make(const std::string &filename, iq_format format,
+                         bool repeat, uint64_t offset, uint64_t len,
+                         bool sc16)
+    {
+      return gnuradio::get_initial_sptr
+        (new iq_file_source_impl(filename, format, repeat, offset, len, sc16));
+    }
+
+    iq_file_source_impl::iq_file_source_impl(const std::string &filename,
+                                             iq_format format, bool repeat,
+                                             uint64_t offset, uint64_t len,
+                                             bool sc16)
+      : gr::sync_block("iq_file_source",
+                       io_signature::make(0, 0, 0),
+                       io_signature::make(1, 1, sc16 ? sizeof(lv_16sc_t)
+                                                     : sizeof(gr_complex))),
+        d_format(format),
+        d_map(NULL),
+        d_maplen(0),
+        d_repeat(repeat),
+        d_sc16(sc16),
+        d_tagged(false),
+        d_rate(0),
+        d_freq(0)
+    {
+      std::string data = filename;
+      std::string base = filename;
+      if(ends_with(base, ".sigmf-meta") || ends_with(base, ".sigmf-data"))
+        base.erase(base.size() - 11);
+      if(file_exists(base + ".sigmf-meta")) {
+        data = base + ".sigmf-data";
+        read_sigmf(base + ".sigmf-meta");
+      }
+      else if(d_format == IQ_AUTO) {
+        if(ends_with(filename, ".cs8")) d_format = IQ_CS8;
+        else if(ends_with(filename, ".cu8")) d_format = IQ_CU8;
+        else if(ends_with(filename, ".cs16")) d_format = IQ_CS16;
+        else d_format = IQ_CF32;
+      }
+
+      switch(d_format) {
+      case IQ_CS8:
+      case IQ_CU8: d_itemsize = 2; break;
+      case IQ_CS16: d_itemsize = 4; break;
+      default: d_itemsize = 8; break;
+      }
+      for(int i = 0; i < 256; i++) {
+        d_cu8[i] = (i - 127.5f)/128.0f;
+        d_cu8_16[i] = (int16_t) ((i - 128)*256 + 128);
+      }
+
+      int fd = open(data.c_str(), O_RDONLY);
+      if(fd < 0)
+        throw std::runtime_error("can't open " + data + ": " + strerror(errno));
+      struct stat st;
+      if(fstat(fd, &st) < 0) {
+        int err = errno;
+        close(fd);
+        throw std::runtime_error("can't stat " + data + ": " + strerror(err));
+      }
+      d_nitems = st.st_size/d_itemsize;
+      d_maplen = d_nitems*d_itemsize;
+      if(d_maplen) {
+        void *map = mmap(NULL, d_maplen, PROT_READ, MAP_SHARED, fd, 0);
+        if(map == MAP_FAILED) {
+          close(fd);
+          throw std::runtime_error("can't map " + data + ": " + strerror(errno));
+        }
+        d_map = (const uint8_t *) map;
+        madvise(map, d_maplen, MADV_SEQUENTIAL);
+      }
+      close(fd);
+
+      d_begin = std::min(offset, d_nitems);
+      d_end = (len == 0) ? d_nitems : std::min(d_begin + len, d_nitems);
+      d_pos = d_begin;
+    }
+
+    iq_file_source_impl::~iq_file_source_impl()
+    {
+      if(d_map)
+        munmap((void *) d_map, d_maplen);
+    }
+
+    void
+    iq_file_source_impl::read_sigmf(const std::string &meta)
+    {
+      std::ifstream f(meta.c_str());
+      std::stringstream ss;
+      ss << f.rdbuf();
+      std::string text = ss.str();
+
+      // A format given to make() overrides the datatype, but the rate
+      // and frequency still come from the metadata
+      size_t pos = json_value(text, "core:datatype");
+      if(d_format == IQ_AUTO) {
+        if(pos == std::string::npos || text[pos] != '"')
+          throw std::runtime_error(meta + ": no core:datatype");
+        std::string type = text.substr(pos + 1, text.find('"', pos + 1) - pos - 1);
+        if(type == "ci8") d_format = IQ_CS8;
+        else if(type == "cu8") d_format = IQ_CU8;
+        else if(type == "ci16_le") d_format = IQ_CS16;
+        else if(type == "cf32_le") d_format = IQ_CF32;
+        else throw std::runtime_error(meta + ": unsupported datatype " + type);
+      }
+
+      if((pos = json_value(text, "core:sample_rate")) != std::string::npos)
+        d_rate = strtod(text.c_str() + pos, NULL);
+      if((pos = json_value(text, "core:frequency")) != std::string::npos)
+        d_freq = strtod(text.c_str() + pos, NULL);
+    }
+
+    void
+    iq_file_source_impl::convert(gr_complex *out, uint64_t pos, int n)
+    {
+      const uint8_t *in = d_map + pos*d_itemsize;
+      switch(d_format) {
+      case IQ_CS8:
+        volk_8i_s32f_convert_32f((float *) out, (const int8_t *) in, 128.0, 2*n);
+        break;
+      case IQ_CU8: {
+        float *o = (float *) out;
+        for(int i = 0; i < 2*n; i++)
+          o[i] = d_cu8[in[i]];
+        break;
+      }
+      case IQ_CS16:
+        volk_16i_s32f_convert_32f((float *) out, (const int16_t *) in, 32768.0, 2*n);
+        break;
+      default:
+        memcpy(out, in, n*sizeof(gr_complex));
+        break;
+      }
+    }
+
+    void
+    iq_file_source_impl::convert(lv_16sc_t *out, uint64_t pos, int n)
+    {
+      const uint8_t *in = d_map + pos*d_itemsize;
+      int16_t *o = (int16_t *) out;
+      switch(d_format) {
+      case IQ_CS8:
+        for(int i = 0; i < 2*n; i++)
+          o[i] = (int16_t) (((const int8_t *) in)[i]*256);
+        break;
+      case IQ_CU8:
+        for(int i = 0; i < 2*n; i++)
+          o[i] = d_cu8_16[in[i]];
+        break;
+      case IQ_CS16:
+        memcpy(out, in, n*sizeof(lv_16sc_t));
+        break;
+      default:
+        volk_32f_s32f_convert_16i(o, (const float *) in, 32768.0, 2*n);
+        break;
+      }
+    }
+
+    int
+    iq_file_source_impl::work(int noutput_items,
+                              gr_vector_const_void_star &input_items,
+                              gr_vector_void_star &output_items)
+    {
+      if(!d_tagged) {
+        if(d_rate > 0)
+          add_item_tag(0, nitems_written(0), pmt::mp("rx_rate"), pmt::from_double(d_rate));
+        if(d_freq > 0)
+          add_item_tag(0, nitems_written(0), pmt::mp("rx_freq"), pmt::from_double(d_freq));
+        d_tagged = true;
+      }
+
+      int nout = 0;
+      while(nout < noutput_items) {
+        if(d_pos == d_end) {
+          if(!d_repeat || d_begin == d_end)
+            break;
+          d_pos = d_begin;
+        }
+        int n = (int) std::min<uint64_t>(noutput_items - nout, d_end - d_pos);
+        if(d_sc16)
+          convert((lv_16sc_t *) output_items[0] + nout, d_pos, n);
+        else
+          convert((gr_complex *) output_items[0] + nout, d_pos, n);
+        d_pos += n;
+        nout += n;
+      }
+      return nout ? nout : WORK_DONE;
+    }
+
+  } /* namespace ais */
+} /* namespace gr */
@@ -0,0 +1,69 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIS_IQ_FILE_SOURCE_IMPL_H
+#define INCLUDED_AIS_IQ_FILE_SOURCE_IMPL_H
+
+#include <ais/iq_file_source.h>
+
+namespace gr {
+  namespace ais {
+
+    class iq_file_source_impl : public iq_file_source
+    {
+     private:
+      iq_format d_format;
+      size_t d_itemsize;        // bytes per complex sample on disk
+      const uint8_t *d_map;
+      size_t d_maplen;
+      uint64_t d_nitems;        // in the whole file
+      uint64_t d_begin, d_end;  // span to play
+      uint64_t d_pos;
+      bool d_repeat;
+      bool d_sc16;
+      bool d_tagged;
+      double d_rate, d_freq;
+      float d_cu8[256];         // cu8 byte to float
+      int16_t d_cu8_16[256];    // and to int16
+
+      void read_sigmf(const std::string &meta);
+      void convert(gr_complex *out, uint64_t pos, int n);
+      void convert(lv_16sc_t *out, uint64_t pos, int n);
+
+     public:
+      iq_file_source_impl(const std::string &filename, iq_format format,
+                          bool repeat, uint64_t offset, uint64_t len,
+                          bool sc16);
+      ~iq_file_source_impl();
+
+      iq_format format() const { return d_format; }
+      uint64_t nitems() const { return d_nitems; }
+      double sample_rate() const { return d_rate; }
+      double center_freq() const { return d_freq; }
+
+      int work(int noutput_items,
+               gr_vector_const_void_star &input_items,
+               gr_vector_void_star &output_items);
+    };
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_AIS_IQ_FILE_SOURCE_IMPL_H */
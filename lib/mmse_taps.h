@@ -0,0 +1,83 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIS_MMSE_TAPS_H
+#define INCLUDED_AIS_MMSE_TAPS_H
+
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/filter/interpolator_taps.h>
+#include <cmath>
+#include <vector>
+
+namespace gr {
+  namespace ais {
+
+    /*!
+     * mmse_fir_interpolator_cc's filter bank, one row of NTAPS per phase
+     * step, reversed into the order the input is read, and a plain dot
+     * product against it. msk_timing_recovery_cc and demod_cb both
+     * interpolate through this rather than through the GNU Radio
+     * interpolator, whose VOLK kernel sums in whatever order the machine
+     * picks, so the two round alike and put out the same bits.
+     */
+    class mmse_taps
+    {
+    public:
+      mmse_taps() : d_taps((NSTEPS+1)*NTAPS)
+      {
+        for(int r = 0; r <= NSTEPS; r++)
+          for(int t = 0; t < NTAPS; t++)
+            d_taps[r*NTAPS + t] = taps[r][NTAPS-1-t];
+      }
+
+      static int ntaps() { return NTAPS; }
+
+      //! Row \p r, for r in [0, NSTEPS]
+      const float *row(int r) const { return &d_taps[r*NTAPS]; }
+
+      //! Row for fractional delay \p mu in [0, 1], as the interpolator rounds it
+      static int row_of(float mu) { return (int) rint(mu*NSTEPS); }
+
+      //! Row \p r against in[0..NTAPS-1]
+      gr_complex filter(const gr_complex *in, int r) const
+      {
+        const float *w = row(r);
+        float re = 0, im = 0;
+        for(int t = 0; t < NTAPS; t++) {
+          re += w[t]*in[t].real();
+          im += w[t]*in[t].imag();
+        }
+        return gr_complex(re, im);
+      }
+
+      //! Interpolated sample at in[3+mu]
+      gr_complex interpolate(const gr_complex *in, float mu) const
+      {
+        return filter(in, row_of(mu));
+      }
+
+    private:
+      std::vector<float> d_taps;
+    };
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_AIS_MMSE_TAPS_H */
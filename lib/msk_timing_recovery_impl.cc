@@ -0,0 +1,633 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+#include <gnuradio/math.h>
+#include <cmath>
+#include "msk_timing_recovery_impl.h"
+#include <ais/corr_detection.h>
+#include <gnuradio/filter/firdes.h>
+#include <gnuradio/filter/interpolator_taps.h>
+#include <algorithm>
+
+namespace gr {
+  namespace ais {
+
+    template <class T>
+    typename msk_timing_recovery<T>::sptr
+    msk_timing_recovery<T>::make(float sps, float gain, float limit, int osps,
+                                 bool burst_gated, int burst_len)
+    {
+      return gnuradio::get_initial_sptr
+        (new msk_timing_recovery_impl<T>(sps, gain, limit, osps,
+                                         burst_gated, burst_len));
+    }
+
+    /*
+     * The private constructor
+     */
+    template <class T>
+    msk_timing_recovery_impl<T>::msk_timing_recovery_impl(float sps, float gain, float limit, int osps,
+                                                          bool burst_gated, int burst_len)
+      : gr::block("msk_timing_recovery",
+              gr::io_signature::make(1, 1, sizeof(T)),
+              gr::io_signature::make3(1, 3, sizeof(T), sizeof(float), sizeof(float))),
+      d_pending(NULL),
+      d_sps(0),
+      d_interp_type(INTERP_MMSE),
+      d_dly_conj_1(0),
+      d_dly_conj_2(0),
+      d_dly_diff_1(0),
+      d_mu(0.5),
+      d_acq_remaining(0),
+      d_div(0),
+      d_osps(osps),
+      d_gate_remaining(0),
+      d_time_est_key(pmt::intern("time_est")),
+      d_corr_det_key(pmt::intern("corr_det")),
+      d_burst_start_key(pmt::intern("burst_start")),
+      d_burst_end_key(pmt::intern("burst_end")),
+      d_src_id(pmt::intern(this->alias())),
+      d_tag(0),
+      d_tags_base(0),
+      d_noutputs(1)
+    {
+        if(d_osps != 1 && d_osps != 2) throw std::out_of_range("osps must be 1 or 2");
+        loop_config c;
+        c.sps = sps;
+        c.gain = gain;
+        c.gain_omega = gain*gain*0.25;
+        c.limit = limit;
+        c.acq_gain = 0;
+        c.acq_gain_omega = 0;
+        c.acq_len = 0;
+        c.gated = burst_gated;
+        c.burst_len = burst_len;
+        c.interp = INTERP_MMSE;
+        publish(c);
+        apply(c);
+        delete d_pending.exchange(NULL);
+        this->enable_update_rate(true); //fixes tag propagation through variable rate blox
+        select_loop(1);
+
+        //the same taps in Q14 for msk_timing_recovery_sc16
+        d_qtaps.resize((NSTEPS+1)*NTAPS);
+        for(int r = 0; r <= NSTEPS; r++) {
+            for(int t = 0; t < NTAPS; t++) {
+                d_qtaps[r*NTAPS + t] = (int16_t) lrintf(d_ftaps.row(r)[t]*(1 << 14));
+            }
+        }
+
+        this->message_port_register_in(pmt::mp("config"));
+        this->set_msg_handler(pmt::mp("config"),
+                              boost::bind(&msk_timing_recovery_impl<T>::handle_config, this, _1));
+    }
+
+    template <class T>
+    msk_timing_recovery_impl<T>::~msk_timing_recovery_impl()
+    {
+        delete d_pending.exchange(NULL);
+    }
+
+    //check c and hand a copy to general_work(), replacing anything it
+    //hasn't picked up yet. call with d_cfg_lock held.
+    template <class T>
+    void msk_timing_recovery_impl<T>::publish(const loop_config &c) {
+        if(c.sps <= 0) throw std::out_of_range("Samples per symbol must be positive");
+        if(c.gain <= 0) throw std::out_of_range("Gain must be positive");
+        if(c.acq_len < 0) throw std::out_of_range("Acquisition length must be nonnegative");
+        if(c.acq_len > 0 && c.acq_gain <= 0) throw std::out_of_range("Gain must be positive");
+        if(c.burst_len <= 0) throw std::out_of_range("Burst length must be positive");
+        d_req = c;
+        delete d_pending.exchange(new loop_config(c));
+    }
+
+    //copy a published config into the loop, from general_work()
+    template <class T>
+    void msk_timing_recovery_impl<T>::apply(const loop_config &c) {
+        if(c.sps/2.0 != d_sps) {
+            d_sps = c.sps/2.0; //loop runs at 2x sps
+            d_omega = d_sps;
+            this->set_relative_rate(d_osps/c.sps);
+        }
+        d_gain = c.gain;
+        d_gain_omega = c.gain_omega;
+        d_limit = c.limit;
+        d_acq_gain = c.acq_gain;
+        d_acq_gain_omega = c.acq_gain_omega;
+        d_acq_len = c.acq_len;
+        d_acq_remaining = std::min(d_acq_remaining, c.acq_len);
+        d_gated = c.gated;
+        d_burst_len = c.burst_len;
+        if(c.interp != d_interp_type) {
+            d_interp_type = c.interp;
+            select_loop(d_noutputs);
+        }
+    }
+
+    //"config" messages: a dict of any of gain, limit, sps, acq_gain,
+    //acq_len, burst_gated and burst_len, or a single (key . value)
+    //pair. everything in one message goes in together.
+    template <class T>
+    void msk_timing_recovery_impl<T>::handle_config(pmt::pmt_t msg) {
+        if(pmt::is_pair(msg) && pmt::is_symbol(pmt::car(msg)))
+            msg = pmt::dict_add(pmt::make_dict(), pmt::car(msg), pmt::cdr(msg));
+        if(!pmt::is_dict(msg)) {
+            GR_LOG_WARN(this->d_logger, "config message is not a dict; ignored");
+            return;
+        }
+
+        gr::thread::scoped_lock lock(d_cfg_lock);
+        loop_config c = d_req;
+        try {
+            pmt::pmt_t v;
+            if(!pmt::is_null(v = pmt::dict_ref(msg, pmt::mp("gain"), pmt::PMT_NIL))) {
+                c.gain = pmt::to_double(v);
+                c.gain_omega = c.gain*c.gain*0.25;
+            }
+            if(!pmt::is_null(v = pmt::dict_ref(msg, pmt::mp("limit"), pmt::PMT_NIL)))
+                c.limit = pmt::to_double(v);
+            if(!pmt::is_null(v = pmt::dict_ref(msg, pmt::mp("sps"), pmt::PMT_NIL)))
+                c.sps = pmt::to_double(v);
+            if(!pmt::is_null(v = pmt::dict_ref(msg, pmt::mp("acq_gain"), pmt::PMT_NIL))) {
+                c.acq_gain = pmt::to_double(v);
+                c.acq_gain_omega = c.acq_gain*c.acq_gain*0.25;
+            }
+            if(!pmt::is_null(v = pmt::dict_ref(msg, pmt::mp("acq_len"), pmt::PMT_NIL)))
+                c.acq_len = pmt::to_long(v);
+            if(!pmt::is_null(v = pmt::dict_ref(msg, pmt::mp("burst_gated"), pmt::PMT_NIL)))
+                c.gated = pmt::to_bool(v);
+            if(!pmt::is_null(v = pmt::dict_ref(msg, pmt::mp("burst_len"), pmt::PMT_NIL)))
+                c.burst_len = pmt::to_long(v);
+            publish(c);
+        }
+        catch(std::exception &e) {
+            GR_LOG_WARN(this->d_logger,
+                        std::string("config message ignored: ") + e.what());
+        }
+    }
+
+    template <class T>
+    void msk_timing_recovery_impl<T>::set_sps(float sps) {
+        gr::thread::scoped_lock lock(d_cfg_lock);
+        loop_config c = d_req;
+        c.sps = sps;
+        publish(c);
+//        set_history(d_sps);
+    }
+
+    template <class T>
+    float msk_timing_recovery_impl<T>::get_sps(void) {
+        gr::thread::scoped_lock lock(d_cfg_lock);
+        return d_req.sps/2.0;
+    }
+
+    template <class T>
+    void msk_timing_recovery_impl<T>::set_gain(float gain) {
+        gr::thread::scoped_lock lock(d_cfg_lock);
+        loop_config c = d_req;
+        c.gain = gain;
+        c.gain_omega = gain*gain*0.25;
+        publish(c);
+    }
+
+    template <class T>
+    float msk_timing_recovery_impl<T>::get_gain(void) {
+        gr::thread::scoped_lock lock(d_cfg_lock);
+        return d_req.gain;
+    }
+
+    template <class T>
+    void msk_timing_recovery_impl<T>::set_acquisition(float gain, int nsymbols) {
+        gr::thread::scoped_lock lock(d_cfg_lock);
+        loop_config c = d_req;
+        c.acq_gain = gain;
+        c.acq_gain_omega = gain*gain*0.25;
+        c.acq_len = nsymbols;
+        publish(c);
+    }
+
+    template <class T>
+    float msk_timing_recovery_impl<T>::get_acquisition_gain(void) {
+        gr::thread::scoped_lock lock(d_cfg_lock);
+        return d_req.acq_gain;
+    }
+
+    template <class T>
+    int msk_timing_recovery_impl<T>::get_acquisition_len(void) {
+        gr::thread::scoped_lock lock(d_cfg_lock);
+        return d_req.acq_len;
+    }
+
+    template <class T>
+    void msk_timing_recovery_impl<T>::set_limit(float limit) {
+        gr::thread::scoped_lock lock(d_cfg_lock);
+        loop_config c = d_req;
+        c.limit = limit;
+        publish(c);
+    }
+
+    template <class T>
+    float msk_timing_recovery_impl<T>::get_limit(void) {
+        gr::thread::scoped_lock lock(d_cfg_lock);
+        return d_req.limit;
+    }
+
+    template <class T>
+    void msk_timing_recovery_impl<T>::set_burst_gated(bool burst_gated) {
+        gr::thread::scoped_lock lock(d_cfg_lock);
+        loop_config c = d_req;
+        c.gated = burst_gated;
+        publish(c);
+    }
+
+    template <class T>
+    bool msk_timing_recovery_impl<T>::get_burst_gated(void) {
+        gr::thread::scoped_lock lock(d_cfg_lock);
+        return d_req.gated;
+    }
+
+    template <class T>
+    void msk_timing_recovery_impl<T>::set_burst_len(int burst_len) {
+        gr::thread::scoped_lock lock(d_cfg_lock);
+        loop_config c = d_req;
+        c.burst_len = burst_len;
+        publish(c);
+    }
+
+    template <class T>
+    int msk_timing_recovery_impl<T>::get_burst_len(void) {
+        gr::thread::scoped_lock lock(d_cfg_lock);
+        return d_req.burst_len;
+    }
+
+    template <class T>
+    void msk_timing_recovery_impl<T>::set_interpolator(interp_type type) {
+        gr::thread::scoped_lock lock(d_cfg_lock);
+        loop_config c = d_req;
+        c.interp = type;
+        publish(c);
+    }
+
+    template <class T>
+    interp_type msk_timing_recovery_impl<T>::get_interpolator(void) {
+        gr::thread::scoped_lock lock(d_cfg_lock);
+        return d_req.interp;
+    }
+
+    template <class T>
+    int
+    msk_timing_recovery_impl<T>::input_margin() const
+    {
+        return NTAPS + (int) ceil(2*d_sps);
+    }
+
+    template <class T>
+    void
+    msk_timing_recovery_impl<T>::forecast (int noutput_items, gr_vector_int &ninput_items_required)
+    {
+        unsigned ninputs = ninput_items_required.size();
+        for(unsigned i=0; i<ninputs; i++) {
+            ninput_items_required[i] = (int)ceil(noutput_items*d_sps*2) + input_margin();
+        }
+    }
+
+    //one row of the MMSE filter bank against in[0..NTAPS-1]
+    template <>
+    inline gr_complex
+    msk_timing_recovery_impl<gr_complex>::interp_row(const gr_complex *in, int row,
+                                                     gr_complex &sample)
+    {
+        sample = d_ftaps.filter(in, row);
+        return sample;
+    }
+
+    //the same in fixed point: Q14 taps, int32 sums, rounded and
+    //saturated back to int16
+    template <>
+    inline gr_complex
+    msk_timing_recovery_impl<lv_16sc_t>::interp_row(const lv_16sc_t *in, int row,
+                                                    lv_16sc_t &sample)
+    {
+        const int16_t *x = (const int16_t *) in;
+        const int16_t *q = &d_qtaps[row*NTAPS];
+        int32_t re = 0, im = 0;
+        for(int t = 0; t < NTAPS; t++) {
+            re += x[2*t]*q[t];
+            im += x[2*t+1]*q[t];
+        }
+        re = std::max(-32768, std::min(32767, (re + (1 << 13)) >> 14));
+        im = std::max(-32768, std::min(32767, (im + (1 << 13)) >> 14));
+        sample = lv_16sc_t(re, im);
+        return gr_complex(re, im)*(1.0f/32768.0f);
+    }
+
+    static inline gr_complex to_float(const gr_complex &x) { return x; }
+    static inline gr_complex to_float(const lv_16sc_t &x) {
+        return gr_complex(x.real(), x.imag())*(1.0f/32768.0f);
+    }
+    static inline void from_float(const gr_complex &x, gr_complex &y) { y = x; }
+    static inline void from_float(const gr_complex &x, lv_16sc_t &y) {
+        float re = std::max(-32768.0f, std::min(32767.0f, rintf(x.real()*32768.0f)));
+        float im = std::max(-32768.0f, std::min(32767.0f, rintf(x.imag()*32768.0f)));
+        y = lv_16sc_t((int16_t) re, (int16_t) im);
+    }
+
+    //INTERP is the interp_type, fixed per loop by select_loop()
+    template <class T>
+    template <int INTERP>
+    inline gr_complex
+    msk_timing_recovery_impl<T>::interpolate(const T *in, int iidx, T &sample)
+    {
+        if(INTERP == INTERP_MMSE)
+            return interp_row(&in[iidx], mmse_taps::row_of(d_mu), sample);
+
+        //the cheaper interpolators, around the same point as the MMSE
+        //filter (between its taps 3 and 4)
+        const float mu = d_mu;
+        const T *x = &in[iidx+2];
+        gr_complex y;
+        if(INTERP == INTERP_LINEAR) {
+            y = to_float(x[1]) + mu*(to_float(x[2]) - to_float(x[1]));
+        }
+        else { //cubic Lagrange through x[0..3], Farrow form
+            gr_complex xm1 = to_float(x[0]), x0 = to_float(x[1]),
+                       x1 = to_float(x[2]), x2 = to_float(x[3]);
+            gr_complex c1 = x1 - xm1*(1.0f/3) - x0*0.5f - x2*(1.0f/6);
+            gr_complex c2 = (xm1 + x1)*0.5f - x0;
+            gr_complex c3 = (x2 - xm1)*(1.0f/6) + (x0 - x1)*0.5f;
+            y = ((c3*mu + c2)*mu + c1)*mu + x0;
+        }
+        from_float(y, sample);
+        return to_float(sample);
+    }
+
+    //pick the loop for this osps, number of connected outputs and
+    //interpolator, so that none of it is tested per sample
+    template <class T>
+    void
+    msk_timing_recovery_impl<T>::select_loop(int noutputs)
+    {
+#define LOOPS(I) \
+        {{&msk_timing_recovery_impl::template run<1,1,I>, \
+          &msk_timing_recovery_impl::template run<1,2,I>, \
+          &msk_timing_recovery_impl::template run<1,3,I>}, \
+         {&msk_timing_recovery_impl::template run<2,1,I>, \
+          &msk_timing_recovery_impl::template run<2,2,I>, \
+          &msk_timing_recovery_impl::template run<2,3,I>}}
+        static const run_fn loops[3][2][3] = {
+            LOOPS(INTERP_MMSE), LOOPS(INTERP_CUBIC), LOOPS(INTERP_LINEAR)
+        };
+#undef LOOPS
+        d_noutputs = std::max(1, std::min(3, noutputs));
+        d_run = loops[d_interp_type][d_osps-1][d_noutputs-1];
+    }
+
+    template <class T>
+    bool
+    msk_timing_recovery_impl<T>::start()
+    {
+        select_loop(this->detail()->noutputs());
+        return block::start();
+    }
+
+    //true if sync() has anything to do before a step at iidx
+    template <class T>
+    inline bool
+    msk_timing_recovery_impl<T>::sync_due(int iidx) const
+    {
+        if(d_gated && d_gate_remaining <= 0) return true;
+        return d_tag < d_tags.size()
+            && (float)(d_tags[d_tag].offset - d_tags_base) < iidx + d_sps;
+    }
+
+    //tag handling ahead of a step: drop tags already passed, skip to the
+    //next burst when gated and idle, and reset the loop on a tag within
+    //this step.
+    template <class T>
+    typename msk_timing_recovery_impl<T>::sync_result
+    msk_timing_recovery_impl<T>::sync(int &iidx, int oidx, int ninp)
+    {
+        //drop any tags we've already run past
+        while(d_tag < d_tags.size() && d_tags[d_tag].offset - d_tags_base < (uint64_t) iidx) {
+            d_tag++;
+        }
+
+        //when gated and idle, skip straight to the next burst, or
+        //swallow the rest of the input if there isn't one.
+        if(d_gated && d_gate_remaining <= 0) {
+            if(d_tag == d_tags.size()) {
+                iidx = ninp;
+                return SYNC_STOP;
+            }
+            iidx = d_tags[d_tag].offset - d_tags_base;
+        }
+
+        //check to see if there's a tag to reset the timing estimate
+        if(d_tag < d_tags.size()) {
+            const tag_t &tag = d_tags[d_tag];
+            int offset = tag.offset - d_tags_base;
+            if((offset >= iidx) && (offset < (iidx+d_sps))) {
+                float center;
+                corr_detection det;
+                if(pmt::eq(tag.key, d_corr_det_key)) {
+                    center = corr_detection_from_pmt(tag.value, det)
+                             ? det.time_est : NAN;
+                }
+                else center = (float) pmt::to_double(tag.value);
+                d_tag++;
+                if(center != center) { //test for NaN, it happens somehow
+                    return (d_gated && d_gate_remaining <= 0) ? SYNC_AGAIN : SYNC_STEP;
+                }
+                d_mu = center;
+                iidx = offset;
+                if(d_mu<0) {
+                    d_mu++;
+                    iidx--;
+                }
+                d_div = 0;
+                d_omega = d_sps;
+                d_dly_conj_2 = d_dly_conj_1;
+                d_acq_remaining = d_acq_len;
+
+                if(d_gated) {
+                    //(re)open the gate. a tag inside an open window
+                    //just extends it.
+                    if(d_gate_remaining <= 0) {
+                        this->add_item_tag(0, this->nitems_written(0) + oidx,
+                                           d_burst_start_key,
+                                           pmt::from_long(d_burst_len*d_osps),
+                                           d_src_id);
+                    }
+                    d_gate_remaining = d_burst_len*d_osps;
+                }
+            }
+        }
+        return SYNC_STEP;
+    }
+
+    //one half-symbol step of the loop. the error loop runs on the odd
+    //(ODD) half; output is on the even half, or both with OSPS 2.
+    template <class T>
+    template <bool ODD, int OSPS, int NOUT, int INTERP>
+    inline void
+    msk_timing_recovery_impl<T>::step(const T *in, int &iidx,
+                                      gr_vector_void_star &output_items, int &oidx)
+    {
+        T sample;
+        //the actual equation for the nonlinearity is as follows:
+        //e(n) = in[n]^2 * in[n-sps].conj()^2
+        //we then differentiate the error by subtracting the sample delayed by d_sps/2
+        gr_complex in_interp = interpolate<INTERP>(in, iidx, sample);
+        gr_complex sq = in_interp*in_interp;
+        //conjugation is distributive.
+        gr_complex dly_conj = std::conj(d_dly_conj_2*d_dly_conj_2);
+        gr_complex nlin_out = sq*dly_conj;
+        //TODO: paper argues that some improvement can be had
+        //if you either operate at >2sps or use a better numeric
+        //differentiation method.
+        float err_out = std::real(nlin_out - d_dly_diff_1);
+        if(ODD) { //error loop calc once per symbol
+            err_out = gr::branchless_clip(err_out, 3.0);
+            //high gain to pull in over the preamble, then track
+            const bool acq = d_acq_remaining > 0;
+            d_acq_remaining -= acq;
+            d_omega += (acq ? d_acq_gain_omega : d_gain_omega)*err_out;
+            d_omega  = d_sps + gr::branchless_clip(d_omega-d_sps, d_limit);
+            d_mu    += (acq ? d_acq_gain : d_gain)*err_out;
+        }
+        //output every other d_sps by default.
+        if(!ODD || OSPS == 2) {
+            ((T *) output_items[0])[oidx] = sample;
+            if(NOUT >= 2) ((float *) output_items[1])[oidx] = err_out;
+            if(NOUT >= 3) ((float *) output_items[2])[oidx] = d_mu;
+            if(d_gated && --d_gate_remaining == 0) {
+                this->add_item_tag(0, this->nitems_written(0) + oidx,
+                                   d_burst_end_key, pmt::PMT_T, d_src_id);
+            }
+            oidx++;
+        }
+        d_div = ODD ? 0 : 1;
+
+        d_dly_conj_1 = in_interp;
+        d_dly_conj_2 = d_dly_conj_1;
+        d_dly_diff_1 = nlin_out;
+
+        //update interpolator twice per symbol
+        d_mu += d_omega;
+        float whole = floorf(d_mu);
+        iidx += (int) whole;
+        d_mu -= whole;
+    }
+
+    //the sample loop, a symbol (two steps) per pass. tags are only looked
+    //at when one is close, and parity only at the top, where a call or a
+    //mid-symbol reset may leave us.
+    template <class T>
+    template <int OSPS, int NOUT, int INTERP>
+    int
+    msk_timing_recovery_impl<T>::run(int noutput_items, int ninp, const T *in,
+                                     gr_vector_void_star &output_items, int &iidx)
+    {
+        int oidx = 0;
+        bool synced = false;
+        while(oidx < noutput_items && iidx < ninp) {
+            if(!synced && sync_due(iidx)) {
+                sync_result r = sync(iidx, oidx, ninp);
+                if(r == SYNC_STOP) break;
+                if(r == SYNC_AGAIN) continue;
+            }
+            synced = false;
+            if(!(d_div & 1)) {
+                step<false, OSPS, NOUT, INTERP>(in, iidx, output_items, oidx);
+                if(oidx >= noutput_items || iidx >= ninp) break;
+                if(sync_due(iidx)) {
+                    sync_result r = sync(iidx, oidx, ninp);
+                    if(r == SYNC_STOP) break;
+                    if(r == SYNC_AGAIN) continue;
+                    if(d_div == 0) { //reset; this is an even step after all
+                        synced = true;
+                        continue;
+                    }
+                }
+            }
+            step<true, OSPS, NOUT, INTERP>(in, iidx, output_items, oidx);
+        }
+        return oidx;
+    }
+
+    template <class T>
+    int
+    msk_timing_recovery_impl<T>::general_work (int noutput_items,
+                       gr_vector_int &ninput_items,
+                       gr_vector_const_void_star &input_items,
+                       gr_vector_void_star &output_items)
+    {
+        //settings published since the last call
+        loop_config *c = d_pending.exchange(NULL);
+        if(c) {
+            apply(*c);
+            delete c;
+        }
+
+        const T *in = (const T *) input_items[0];
+        int iidx=0;
+        int ninp=ninput_items[0] - input_margin();
+        if(ninp <= 0) {
+            this->consume_each(0);
+            return(0);
+        }
+
+        //timing resets come either as plain time_est tags or as the
+        //single-record corr_det tags from corr_est_cc
+        std::vector<tag_t> all_tags;
+        d_tags_base = this->nitems_read(0);
+        this->get_tags_in_range(all_tags,
+                                0,
+                                d_tags_base,
+                                d_tags_base+ninp);
+        d_tags.clear();
+        d_tag = 0;
+        for(size_t t = 0; t < all_tags.size(); t++) {
+            if(pmt::eq(all_tags[t].key, d_time_est_key)
+               or pmt::eq(all_tags[t].key, d_corr_det_key))
+                d_tags.push_back(all_tags[t]);
+        }
+
+        int oidx = (this->*d_run)(noutput_items, ninp, in, output_items, iidx);
+
+        this->consume_each (iidx);
+        return oidx;
+    }
+
+    template class msk_timing_recovery<gr_complex>;
+    template class msk_timing_recovery<lv_16sc_t>;
+    template class msk_timing_recovery_impl<gr_complex>;
+    template class msk_timing_recovery_impl<lv_16sc_t>;
+
+  } /* namespace ais */
+} /* namespace gr */
+
@@ -0,0 +1,159 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2014 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_DIGITAL_MSK_TIMING_RECOVERY_IMPL_H
+#define INCLUDED_DIGITAL_MSK_TIMING_RECOVERY_IMPL_H
+
+#include <ais/msk_timing_recovery_cc.h>
+#include <boost/circular_buffer.hpp>
+#include <gnuradio/filter/fir_filter_with_buffer.h>
+#include <gnuradio/thread/thread.h>
+#include "mmse_taps.h"
+#include <atomic>
+
+namespace gr {
+  namespace ais {
+
+    template <class T>
+    class msk_timing_recovery_impl : public msk_timing_recovery<T>
+    {
+     private:
+        //everything a setter can change. setters publish a whole copy,
+        //which general_work() picks up at the top of its next call, so
+        //the loop runs without a lock.
+        struct loop_config {
+            float sps;
+            float gain, gain_omega;
+            float limit;
+            float acq_gain, acq_gain_omega;
+            int acq_len;
+            bool gated;
+            int burst_len;
+            interp_type interp;
+        };
+        mutable gr::thread::mutex d_cfg_lock;
+        loop_config d_req;            //as last set, for the getters
+        std::atomic<loop_config *> d_pending;
+        void publish(const loop_config &c);
+        void apply(const loop_config &c);
+        void handle_config(pmt::pmt_t msg);
+
+        //the loop's copy of the above
+        float d_sps;
+        float d_gain;
+        float d_limit;
+        //the MMSE filter bank, one row of NTAPS per phase step, in the
+        //order the input is read: float, and Q14 for sc16
+        mmse_taps d_ftaps;
+        std::vector<int16_t> d_qtaps;
+        interp_type d_interp_type;
+        filter::kernel::fir_filter_with_buffer_fff *d_decim;
+        gr_complex d_dly_conj_1, d_dly_conj_2, d_dly_diff_1;
+        float d_mu, d_omega, d_gain_omega;
+        //acquisition gear: gains used for d_acq_len symbols after a reset
+        float d_acq_gain, d_acq_gain_omega;
+        int d_acq_len, d_acq_remaining;
+        int d_div;
+        int d_osps;
+        int d_loop_rate;
+        bool d_gated;
+        int d_burst_len;
+        int d_gate_remaining;
+        const pmt::pmt_t d_time_est_key;
+        const pmt::pmt_t d_corr_det_key;
+        const pmt::pmt_t d_burst_start_key;
+        const pmt::pmt_t d_burst_end_key;
+        const pmt::pmt_t d_src_id;
+
+        //interpolated sample at in[iidx+3+d_mu], in float for the loop,
+        //and as output
+        template <int INTERP>
+        gr_complex interpolate(const T *in, int iidx, T &sample);
+        gr_complex interp_row(const T *in, int row, T &sample);
+
+        //input held back from the end of each call: a step at iidx reads
+        //in[iidx..iidx+NTAPS-1], plus a symbol of slack for omega
+        int input_margin() const;
+
+        //timing resets for the current call, from d_tag on
+        std::vector<tag_t> d_tags;
+        size_t d_tag;
+        uint64_t d_tags_base;
+
+        enum sync_result { SYNC_STEP, SYNC_AGAIN, SYNC_STOP };
+        bool sync_due(int iidx) const;
+        sync_result sync(int &iidx, int oidx, int ninp);
+
+        template <bool ODD, int OSPS, int NOUT, int INTERP>
+        void step(const T *in, int &iidx, gr_vector_void_star &output_items, int &oidx);
+        template <int OSPS, int NOUT, int INTERP>
+        int run(int noutput_items, int ninp, const T *in,
+                gr_vector_void_star &output_items, int &iidx);
+
+        typedef int (msk_timing_recovery_impl::*run_fn)(int, int, const T *,
+                                                        gr_vector_void_star &, int &);
+        run_fn d_run;
+        int d_noutputs;
+        void select_loop(int noutputs);
+
+     public:
+      msk_timing_recovery_impl(float sps, float gain, float limit, int osps,
+                               bool burst_gated, int burst_len);
+      ~msk_timing_recovery_impl();
+
+      bool start();
+
+      // Where all the action really happens
+      void forecast (int noutput_items, gr_vector_int &ninput_items_required);
+
+      int general_work(int noutput_items,
+                       gr_vector_int &ninput_items,
+                       gr_vector_const_void_star &input_items,
+                       gr_vector_void_star &output_items);
+      void set_gain(float gain);
+      float get_gain(void);
+
+      void set_limit(float limit);
+      float get_limit(void);
+
+      void set_acquisition(float gain, int nsymbols);
+      float get_acquisition_gain(void);
+      int get_acquisition_len(void);
+
+      void set_sps(float sps);
+      float get_sps(void);
+
+      void set_burst_gated(bool burst_gated);
+      bool get_burst_gated(void);
+
+      void set_burst_len(int burst_len);
+      int get_burst_len(void);
+
+      void set_interpolator(interp_type type);
+      interp_type get_interpolator(void);
+
+    };
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_DIGITAL_MSK_TIMING_RECOVERY_IMPL_H */
+
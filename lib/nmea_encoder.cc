@@ -0,0 +1,168 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <ais/nmea_encoder.h>
+#include <algorithm>
+
+namespace gr {
+  namespace ais {
+
+    namespace {
+      const size_t nmea_max = 56; //armored characters per sentence
+      const size_t frag_bytes = nmea_max/4*3;
+
+      //six-bit value to AIS payload character
+      const char armor[] = "0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVW"
+                           "`abcdefghijklmnopqrstuvw";
+      const char hex[] = "0123456789ABCDEF";
+
+      size_t
+      digits(size_t v)
+      {
+        size_t n = 1;
+        while(v /= 10) n++;
+        return n;
+      }
+
+      //writes characters, keeping the NMEA checksum as it goes
+      struct sentence_writer
+      {
+        char *p;
+        uint8_t sum;
+
+        void put(char c) { *p++ = c; sum ^= c; }
+
+        void put(const char *s, size_t n) { while(n--) put(*s++); }
+
+        void put_num(size_t v)
+        {
+          char tmp[20];
+          int n = 0;
+          do tmp[n++] = '0' + v % 10; while(v /= 10);
+          while(n) put(tmp[--n]);
+        }
+
+        void put_payload(const uint8_t *d, size_t n)
+        {
+          for(; n >= 3; n -= 3, d += 3) {
+            uint32_t v = (d[0] << 16) | (d[1] << 8) | d[2];
+            put(armor[v >> 18]);
+            put(armor[(v >> 12) & 0x3F]);
+            put(armor[(v >> 6) & 0x3F]);
+            put(armor[v & 0x3F]);
+          }
+          //the pad bits are zero
+          if(n == 2) {
+            uint32_t v = (d[0] << 16) | (d[1] << 8);
+            put(armor[v >> 18]);
+            put(armor[(v >> 12) & 0x3F]);
+            put(armor[(v >> 6) & 0x3F]);
+          }
+          else if(n == 1) {
+            uint32_t v = d[0] << 16;
+            put(armor[v >> 18]);
+            put(armor[(v >> 12) & 0x3F]);
+          }
+        }
+      };
+    }
+
+    nmea_encoder::nmea_encoder(const std::string &designator)
+      : d_designator(designator)
+    {
+    }
+
+    size_t
+    nmea_encoder::max_length(size_t len) const
+    {
+      size_t nchars = (len*8 + 5) / 6;
+      size_t nfrags = nchars ? 1 + (nchars-1) / nmea_max : 1;
+      //"!AIVDM,n,i,,d," + ",p*HH" + newline between sentences
+      size_t overhead = 17 + 2*digits(nfrags) + d_designator.size();
+      return nfrags*overhead + nchars;
+    }
+
+    size_t
+    nmea_encoder::encode(const uint8_t *data, size_t len,
+                         char *buf, size_t size) const
+    {
+      if(size < max_length(len))
+        return 0;
+
+      const size_t nbits = len*8;
+      const size_t npad = (6 - (nbits % 6)) % 6;
+      const size_t nchars = (nbits + npad) / 6;
+      const size_t nfrags = nchars ? 1 + (nchars-1) / nmea_max : 1;
+
+      //56 characters is exactly 42 bytes, so each sentence armors whole
+      //bytes and only the last one has any padding; the others say 0.
+      sentence_writer w;
+      w.p = buf;
+      for(size_t frag = 1; frag <= nfrags; frag++) {
+        if(frag > 1) *w.p++ = '\n';
+        *w.p++ = '!'; //not in the checksum
+        w.sum = 0;
+        w.put("AIVDM,", 6);
+        w.put_num(nfrags);
+        w.put(',');
+        w.put_num(frag);
+        w.put(",,", 2);
+        w.put(d_designator.data(), d_designator.size());
+        w.put(',');
+
+        size_t n = std::min(len, frag_bytes);
+        w.put_payload(data, n);
+        data += n;
+        len -= n;
+
+        w.put(',');
+        w.put_num(frag == nfrags ? npad : 0);
+        *w.p++ = '*';
+        *w.p++ = hex[w.sum >> 4];
+        *w.p++ = hex[w.sum & 0x0F];
+      }
+      return w.p - buf;
+    }
+
+    size_t
+    nmea_encoder::encode(const uint8_t *const *data, const size_t *len,
+                         size_t n, char *buf, size_t size,
+                         size_t &nwritten) const
+    {
+      char *p = buf;
+      size_t i;
+      for(i = 0; i < n; i++) {
+        size_t left = size - (p - buf);
+        size_t m = (left > 0) ? encode(data[i], len[i], p, left - 1) : 0;
+        if(m == 0)
+          break;
+        p[m] = '\n';
+        p += m + 1;
+      }
+      nwritten = p - buf;
+      return i;
+    }
+
+  } /* namespace ais */
+} /* namespace gr */
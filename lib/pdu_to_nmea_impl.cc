@@ -22,7 +22,7 @@
 #include "config.h"
 #endif
 
-#include <cstdio>
+#include <iostream>
 #include <gnuradio/io_signature.h>
 #include "pdu_to_nmea_impl.h"
 
@@ -43,7 +43,7 @@ namespace gr {
       : block("pdu_to_nmea",
               io_signature::make(0,0,0),
               io_signature::make(0,0,0)),
-        d_designator(designator)
+        d_encoder(designator)
     {
         message_port_register_in(pmt::mp("print"));
         set_msg_handler(pmt::mp("print"), boost::bind(&pdu_to_nmea_impl::print, this, _1));
@@ -59,86 +59,44 @@ namespace gr {
     {
     }
 
-    //TODO: test with padding more thoroughly
-    std::vector<uint8_t> pdu_to_nmea_impl::unpack_bits(pmt::pmt_t msg, uint8_t *npad) {
-        const uint8_t *p = (const uint8_t *) pmt::blob_data(pmt::cdr(msg));
-        int len = pmt::blob_length(pmt::cdr(msg));
-        int nbits = len*8;
-        *npad = (6-(nbits % 6)) % 6;
-        int padded_len = nbits+*npad;
-        std::vector<uint8_t> up(padded_len/6, 0);
-        for(int i=0; i<nbits; i++) {
-            uint8_t bit = (p[i/8] >> (7-(i%8))) & 1;
-            up[i/6] |= (bit << (5-(i%6)));
+    size_t pdu_to_nmea_impl::format(pmt::pmt_t msg) {
+        if(!pmt::is_vector(msg)) {
+            const uint8_t *p = (const uint8_t *) pmt::blob_data(pmt::cdr(msg));
+            size_t len = pmt::blob_length(pmt::cdr(msg));
+            size_t max = d_encoder.max_length(len);
+            if(d_buf.size() < max) d_buf.resize(max);
+            return d_encoder.encode(p, len, &d_buf[0], d_buf.size());
         }
-        for(int i=0;i<*npad; i++) {
-            up[nbits/6] <<= 1;
-        }
-
-        return up;
-    }
-
-    std::string pdu_to_nmea_impl::to_ascii(std::vector<uint8_t> msg) {
-        std::string ret(msg.begin(), msg.end());
-        for(int i=0; i<ret.size(); i++) {
-            if(ret[i] > 39) ret[i] += 8;
-            ret[i] += char(48);
-        }
-        return ret;
-    }
 
-    uint8_t pdu_to_nmea_impl::get_checksum(std::string &msg) {
-        unsigned int i = 0;
-        uint8_t sum = 0x00;
-        if(msg[0] == '!') i++;
-        for(; i < msg.length(); i++) sum ^= msg[i];
-        return sum;
-    }
-
-
-    std::string pdu_to_nmea_impl::to_sentence(std::string ascii, uint8_t npad) {
-        int frag_id = 1;
-        int frag_offset = 0;
-        std::string ret;
-        const int nmea_max=56; //minus overhead from sentence structure
-        const int num_frags = 1+((ascii.length()-1) / nmea_max);
-        while(frag_id <= num_frags) {
-            if(frag_id > 1) ret += "\n";
-            std::string this_sentence =  "!AIVDM,"
-                                         + boost::to_string(num_frags)
-                                         + ","
-                                         + boost::to_string(frag_id++)
-                                         + ",,"
-                                         + d_designator
-                                         + ",";
-
-            std::string this_frag = ascii.substr(frag_offset, nmea_max);
-            frag_offset += this_frag.length();
-            this_sentence += this_frag + "," + boost::to_string(int(npad));
-            char wat[3];
-            uint8_t checksum = get_checksum(this_sentence);
-            snprintf(wat, 3, "%02X", checksum); //NMEA 0183 checksum
-            this_sentence += "*" + std::string(wat);
-            ret += this_sentence;
+        //a batch: a PMT vector of PDUs, formatted into one block of text
+        size_t n = pmt::length(msg);
+        if(n == 0) return 0;
+        d_data.resize(n);
+        d_lens.resize(n);
+        size_t max = 0;
+        for(size_t i=0; i<n; i++) {
+            pmt::pmt_t v = pmt::cdr(pmt::vector_ref(msg, i));
+            d_data[i] = (const uint8_t *) pmt::blob_data(v);
+            d_lens[i] = pmt::blob_length(v);
+            max += d_encoder.max_length(d_lens[i]) + 1;
         }
-        return ret;
-    }
-
-    std::string pdu_to_nmea_impl::msg_to_sentence(pmt::pmt_t msg) {
-        uint8_t npad;
-        std::vector<uint8_t> unpacked = unpack_bits(msg, &npad);
-        return to_sentence(to_ascii(unpacked), npad);
+        if(d_buf.size() < max) d_buf.resize(max);
+        size_t nwritten;
+        d_encoder.encode(&d_data[0], &d_lens[0], n, &d_buf[0], d_buf.size(), nwritten);
+        return nwritten - 1; //drop the last newline
     }
 
     void pdu_to_nmea_impl::print(pmt::pmt_t msg) {
-        std::cout << msg_to_sentence(msg) << std::endl;
+        size_t len = format(msg);
+        std::cout.write(&d_buf[0], len);
+        std::cout << std::endl;
     }
 
     void pdu_to_nmea_impl::to_nmea(pmt::pmt_t msg) {
-        std::string aivdm = msg_to_sentence(msg);
+        size_t len = format(msg);
         //make PDU
         pmt::pmt_t pdu(pmt::cons(pmt::PMT_NIL,
-                                 pmt::init_u8vector(aivdm.length(), (uint8_t *)aivdm.c_str())));
+                                 pmt::init_u8vector(len, (const uint8_t *) &d_buf[0])));
         //post to output port
         message_port_pub(pmt::mp("out"), pdu);
     }
@@ -22,6 +22,7 @@
 #define INCLUDED_AIS_PDU_TO_NMEA_IMPL_H
 
 #include <ais/pdu_to_nmea.h>
+#include <ais/nmea_encoder.h>
 #include <pmt/pmt.h>
 #include <string>
 
@@ -33,13 +34,12 @@ namespace gr {
      private:
          void print(pmt::pmt_t msg);
          void to_nmea(pmt::pmt_t msg);
-         std::vector<uint8_t> unpack_bits(pmt::pmt_t msg, uint8_t *npad);
-         std::string to_ascii(std::vector<uint8_t> msg);
-         uint8_t get_checksum(std::string &msg);
-         std::string to_sentence(std::string ascii, uint8_t npad);
-         std::string msg_to_sentence(pmt::pmt_t msg);
+         size_t format(pmt::pmt_t msg);
 
-         std::string d_designator;
+         nmea_encoder d_encoder;
+         std::vector<char> d_buf; //reused between messages
+         std::vector<const uint8_t *> d_data;
+         std::vector<size_t> d_lens;
 
      public:
       pdu_to_nmea_impl(std::string designator);
@@ -26,11 +26,17 @@
  */
 
 #include "qa_ais.h"
+#include "qa_sliding_max.h"
+#include "qa_hdlc_deframer_bp.h"
+#include "qa_nmea_encoder.h"
 
 CppUnit::TestSuite *
 qa_ais::suite()
 {
   CppUnit::TestSuite *s = new CppUnit::TestSuite("ais");
+  s->addTest(gr::ais::qa_sliding_max::suite());
+  s->addTest(gr::ais::qa_hdlc_deframer_bp::suite());
+  s->addTest(gr::ais::qa_nmea_encoder::suite());
 
   return s;
 }
@@ -0,0 +1,257 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "qa_hdlc_deframer_bp.h"
+#include <ais/hdlc_deframer_bp.h>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/vector_source.h>
+#include <gnuradio/blocks/message_debug.h>
+#include <cppunit/TestAssert.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace gr {
+  namespace ais {
+
+    // A channel bit stream and a confidence for each bit, in the order
+    // the deframer takes them
+    struct soft_bits
+    {
+      std::vector<uint8_t> bits;
+      std::vector<uint8_t> conf;
+
+      void put(uint8_t bit, uint8_t c)
+      {
+        bits.push_back(bit);
+        conf.push_back(c);
+      }
+
+      void flag()
+      {
+        const uint8_t f[] = {0, 1, 1, 1, 1, 1, 1, 0};
+        for(int k = 0; k < 8; k++)
+          put(f[k], 255);
+      }
+
+      // A frame body, with a zero stuffed after every five ones
+      void body(const std::vector<uint8_t> &b, const std::vector<uint8_t> &c)
+      {
+        int ones = 0;
+        for(size_t n = 0; n < b.size(); n++) {
+          put(b[n], c[n]);
+          ones = b[n] ? ones + 1 : 0;
+          if(ones == 5) {
+            put(0, 255);
+            ones = 0;
+          }
+        }
+      }
+    };
+
+    // Close the stream with a flag, pad it to whole bytes and pack it
+    // first bit in the MSB, NRZI coding it (a zero is a change) if asked
+    static std::vector<uint8_t>
+    pack(soft_bits &s, bool nrzi)
+    {
+      s.flag();
+      while(s.bits.size() % 8)
+        s.put(1, 255);
+
+      std::vector<uint8_t> packed(s.bits.size()/8, 0);
+      uint8_t level = 0;
+      for(size_t n = 0; n < s.bits.size(); n++) {
+        level = nrzi ? level ^ !s.bits[n] : s.bits[n];
+        packed[n/8] |= level << (7 - n%8);
+      }
+      return packed;
+    }
+
+    // Run the bits through a deframer and return the number of frames it
+    // recovered by flipping
+    static uint64_t
+    run(soft_bits s, int flip_bits)
+    {
+      std::vector<uint8_t> packed = pack(s, true);
+
+      top_block_sptr tb = make_top_block("qa_hdlc_deframer_bp");
+      blocks::vector_source<uint8_t>::sptr src =
+        blocks::vector_source<uint8_t>::make(packed);
+      blocks::vector_source<uint8_t>::sptr conf =
+        blocks::vector_source<uint8_t>::make(s.conf, false, 8);
+      hdlc_deframer_bp::sptr deframer =
+        hdlc_deframer_bp::make(11, 64, true, flip_bits);
+      tb->connect(src, 0, deframer, 0);
+      tb->connect(conf, 0, deframer, 1);
+      tb->run();
+      return deframer->recovered();
+    }
+
+    // nframes frames of random bits, 11 to 64 bytes and an FCS long, with
+    // ndoubtful of the bits below the deframer's default confidence floor
+    // and the rest well above it
+    static soft_bits
+    noise_frames(std::mt19937 &rng, int nframes, int ndoubtful)
+    {
+      std::uniform_int_distribution<int> len(11, 64), bit(0, 1);
+      std::uniform_int_distribution<int> low(0, 15), high(64, 254);
+      soft_bits s;
+      for(int f = 0; f < nframes; f++) {
+        int nbits = 8*(len(rng) + 2);
+        std::vector<uint8_t> b(nbits), c(nbits);
+        for(int n = 0; n < nbits; n++) {
+          b[n] = bit(rng);
+          c[n] = high(rng);
+        }
+        for(int d = 0; d < ndoubtful; ) {
+          int n = std::uniform_int_distribution<int>(0, nbits - 1)(rng);
+          if(c[n] >= 16) {
+            c[n] = low(rng);
+            d++;
+          }
+        }
+        s.flag();
+        s.body(b, c);
+      }
+      return s;
+    }
+
+    // Run the bits through a deframer without confidences and return the
+    // frames it posted
+    static std::vector<std::vector<uint8_t> >
+    deframe(soft_bits s, bool nrzi)
+    {
+      top_block_sptr tb = make_top_block("qa_hdlc_deframer_bp");
+      blocks::vector_source<uint8_t>::sptr src =
+        blocks::vector_source<uint8_t>::make(pack(s, nrzi));
+      hdlc_deframer_bp::sptr deframer = hdlc_deframer_bp::make(11, 64, nrzi);
+      blocks::message_debug::sptr sink = blocks::message_debug::make();
+      tb->connect(src, 0, deframer, 0);
+      tb->msg_connect(deframer, "out", sink, "store");
+      tb->run();
+
+      std::vector<std::vector<uint8_t> > frames;
+      for(int m = 0; m < sink->num_messages(); m++) {
+        pmt::pmt_t vec = pmt::cdr(sink->get_message(m));
+        size_t len = pmt::length(vec);
+        const uint8_t *data = pmt::u8vector_elements(vec, len);
+        frames.push_back(std::vector<uint8_t>(data, data + len));
+      }
+      return frames;
+    }
+
+    // CRC-16/X.25, bitwise
+    static uint16_t
+    fcs(const std::vector<uint8_t> &p)
+    {
+      uint16_t crc = 0xFFFF;
+      for(size_t n = 0; n < p.size(); n++) {
+        crc ^= p[n];
+        for(int b = 0; b < 8; b++)
+          crc = (crc & 1) ? (crc >> 1) ^ 0x8408 : (crc >> 1);
+      }
+      return crc ^ 0xFFFF;
+    }
+
+    void
+    qa_hdlc_deframer_bp::t_noise()
+    {
+      // What soft_slicer_fb makes of noise alone: for unit Gaussian x the
+      // mean |x| is sqrt(2/pi) and the variance about it 1 - 2/pi, so a
+      // good part of every frame's bits are doubtful and none is tried.
+      std::mt19937 rng(1);
+      std::normal_distribution<float> gauss(0, 1);
+      soft_bits s = noise_frames(rng, 2000, 0);
+      const float mean = sqrtf(2/M_PI), var = 1 - 2/M_PI;
+      for(size_t n = 0; n < s.conf.size(); n++) {
+        if(s.conf[n] == 255)
+          continue; //flags and stuffed bits
+        float llr = 2*mean*fabsf(gauss(rng))/var;
+        s.conf[n] = (uint8_t) std::min(255.0f, 4*llr + 0.5f);
+      }
+      CPPUNIT_ASSERT_EQUAL((uint64_t) 0, run(s, 8));
+    }
+
+    void
+    qa_hdlc_deframer_bp::t_doubtful()
+    {
+      // With 8 doubtful bits every failed frame gets 255 combinations,
+      // each passing the CRC by chance one time in 65536
+      std::mt19937 rng(2);
+      const int nframes = 5000;
+      const double expect = nframes*255/65536.0;
+      uint64_t passed = run(noise_frames(rng, nframes, 8), 8);
+      CPPUNIT_ASSERT(passed > 0);
+      CPPUNIT_ASSERT(passed < 2*expect);
+    }
+
+    void
+    qa_hdlc_deframer_bp::t_too_doubtful()
+    {
+      // One doubtful bit more than flip_bits and no frame is tried
+      std::mt19937 rng(3);
+      CPPUNIT_ASSERT_EQUAL((uint64_t) 0, run(noise_frames(rng, 5000, 5), 4));
+    }
+
+    void
+    qa_hdlc_deframer_bp::t_alignment()
+    {
+      // Random payloads, some all ones for the stuffing, each framed by
+      // its own flags with 0 to 7 idle bits ahead, so that flags and
+      // frames start at every bit position of the packed bytes; with and
+      // without NRZI. Every frame comes out whole and in order.
+      std::mt19937 rng(4);
+      std::uniform_int_distribution<int> len(11, 64), byte(0, 255);
+      for(int nrzi = 0; nrzi < 2; nrzi++) {
+        for(int lead = 0; lead < 8; lead++) {
+          soft_bits s;
+          std::vector<std::vector<uint8_t> > sent;
+          for(int f = 0; f < 64; f++) {
+            std::vector<uint8_t> p(len(rng));
+            for(size_t n = 0; n < p.size(); n++)
+              p[n] = (f % 4 == 3) ? 0xFF : byte(rng);
+            sent.push_back(p);
+
+            const uint16_t crc = fcs(p);
+            p.push_back(crc & 0xFF);
+            p.push_back(crc >> 8);
+            std::vector<uint8_t> b, c;
+            for(size_t n = 0; n < p.size(); n++)
+              for(int k = 0; k < 8; k++) { //first bit in the LSB
+                b.push_back((p[n] >> k) & 1);
+                c.push_back(255);
+              }
+            for(int k = 0; k < (lead + f) % 8; k++)
+              s.put(0, 255);
+            s.flag();
+            s.body(b, c);
+            s.flag();
+          }
+
+          std::vector<std::vector<uint8_t> > got = deframe(s, nrzi);
+          CPPUNIT_ASSERT_EQUAL(sent.size(), got.size());
+          for(size_t f = 0; f < sent.size(); f++)
+            CPPUNIT_ASSERT(sent[f] == got[f]);
+        }
+      }
+    }
+
+  } /* namespace ais */
+} /* namespace gr */
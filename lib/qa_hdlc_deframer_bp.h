@@ -0,0 +1,50 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIS_QA_HDLC_DEFRAMER_BP_H
+#define INCLUDED_AIS_QA_HDLC_DEFRAMER_BP_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestCase.h>
+
+namespace gr {
+  namespace ais {
+
+    class qa_hdlc_deframer_bp : public CppUnit::TestCase
+    {
+    public:
+      CPPUNIT_TEST_SUITE(qa_hdlc_deframer_bp);
+      CPPUNIT_TEST(t_noise);
+      CPPUNIT_TEST(t_doubtful);
+      CPPUNIT_TEST(t_too_doubtful);
+      CPPUNIT_TEST(t_alignment);
+      CPPUNIT_TEST_SUITE_END();
+
+    private:
+      void t_noise();
+      void t_doubtful();
+      void t_too_doubtful();
+      void t_alignment();
+    };
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_AIS_QA_HDLC_DEFRAMER_BP_H */
@@ -0,0 +1,102 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "qa_nmea_encoder.h"
+#include <ais/nmea_encoder.h>
+#include <cppunit/TestAssert.h>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace gr {
+  namespace ais {
+
+    // pdu_to_nmea's sentences as it made them before nmea_encoder, with
+    // two fixes. The fill bit count is only on the last fragment, as NMEA
+    // has it; the others armor whole bytes and have no fill bits. And the
+    // last character is no longer shifted left by the fill count: its
+    // bits are already in place, so that shift lost them.
+    static std::string
+    old_pdu_to_nmea(const std::vector<uint8_t> &p, const std::string &designator)
+    {
+      int nbits = p.size()*8;
+      int npad = (6 - (nbits % 6)) % 6;
+      std::vector<uint8_t> up((nbits + npad)/6, 0);
+      for(int i = 0; i < nbits; i++) {
+        uint8_t bit = (p[i/8] >> (7 - (i%8))) & 1;
+        up[i/6] |= (bit << (5 - (i%6)));
+      }
+
+      std::string ascii(up.begin(), up.end());
+      for(size_t i = 0; i < ascii.size(); i++) {
+        if(ascii[i] > 39) ascii[i] += 8;
+        ascii[i] += char(48);
+      }
+
+      const int nmea_max = 56;
+      const int num_frags = 1 + ((ascii.length() - 1) / nmea_max);
+      std::string ret;
+      int frag_offset = 0;
+      for(int frag_id = 1; frag_id <= num_frags; frag_id++) {
+        if(frag_id > 1) ret += "\n";
+        std::string s = "!AIVDM," + std::to_string(num_frags) + ","
+                        + std::to_string(frag_id) + ",," + designator + ",";
+        std::string frag = ascii.substr(frag_offset, nmea_max);
+        frag_offset += frag.length();
+        s += frag + "," + std::to_string(frag_id == num_frags ? npad : 0);
+        uint8_t sum = 0;
+        for(size_t i = 1; i < s.length(); i++)
+          sum ^= s[i];
+        char hex[3];
+        snprintf(hex, 3, "%02X", sum);
+        ret += s + "*" + hex;
+      }
+      return ret;
+    }
+
+    void
+    qa_nmea_encoder::t_pdu_to_nmea()
+    {
+      // One to four sentences, with 0, 1 and 2 bytes left over from
+      // whole 3-byte groups (0, 2 and 4 fill bits) in the last
+      std::mt19937 rng(1);
+      std::uniform_int_distribution<int> byte(0, 255);
+      const size_t lens[] = {1, 2, 3, 20, 21, 22, 41, 42, 43, 44, 45,
+                             83, 84, 85, 86, 127, 128, 129, 168};
+      const std::string designators[] = {"A", "B"};
+      for(size_t d = 0; d < 2; d++) {
+        nmea_encoder enc(designators[d]);
+        for(size_t l = 0; l < sizeof(lens)/sizeof(lens[0]); l++) {
+          std::vector<uint8_t> p(lens[l]);
+          for(size_t n = 0; n < p.size(); n++)
+            p[n] = byte(rng);
+
+          std::vector<char> buf(enc.max_length(p.size()));
+          size_t m = enc.encode(&p[0], p.size(), &buf[0], buf.size());
+          CPPUNIT_ASSERT(m > 0);
+          CPPUNIT_ASSERT_EQUAL(old_pdu_to_nmea(p, designators[d]),
+                               std::string(&buf[0], m));
+        }
+      }
+    }
+
+  } /* namespace ais */
+} /* namespace gr */
@@ -0,0 +1,81 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "qa_sliding_max.h"
+#include "sliding_max.h"
+#include <cppunit/TestAssert.h>
+#include <algorithm>
+#include <random>
+
+namespace gr {
+  namespace ais {
+
+    // Push x through a sliding_max of length len and check every output
+    // against the maximum of the window found by brute force
+    static void
+    check(const std::vector<float> &x, int len)
+    {
+      sliding_max m(len);
+      for(size_t n = 0; n < x.size(); n++) {
+        size_t first = n + 1 >= (size_t) len ? n + 1 - len : 0;
+        float expect = *std::max_element(x.begin() + first, x.begin() + n + 1);
+        CPPUNIT_ASSERT_EQUAL(expect, m.push(x[n]));
+      }
+    }
+
+    void
+    qa_sliding_max::t_decreasing()
+    {
+      // Every value stays in the queue until it expires
+      std::vector<float> x(100);
+      for(size_t n = 0; n < x.size(); n++)
+        x[n] = 100.0f - n;
+      check(x, 8);
+      check(x, 7);
+      check(x, 100);
+    }
+
+    void
+    qa_sliding_max::t_random()
+    {
+      std::mt19937 rng(1);
+      std::uniform_real_distribution<float> u(0, 1);
+      std::vector<float> x(5000);
+      for(size_t n = 0; n < x.size(); n++)
+        x[n] = u(rng);
+      // with runs of falling and repeated values
+      for(size_t n = 1000; n < 1200; n++)
+        x[n] = 2.0f - n/1000.0f;
+      for(size_t n = 2000; n < 2100; n++)
+        x[n] = 0.5f;
+      const int lens[] = {2, 3, 8, 64, 257};
+      for(size_t i = 0; i < sizeof(lens)/sizeof(lens[0]); i++)
+        check(x, lens[i]);
+    }
+
+    void
+    qa_sliding_max::t_len_one()
+    {
+      const float x[] = {3, 1, 4, 1, 5, 9, 2, 6};
+      check(std::vector<float>(x, x + 8), 1);
+    }
+
+  } /* namespace ais */
+} /* namespace gr */
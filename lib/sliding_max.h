@@ -0,0 +1,77 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIS_SLIDING_MAX_H
+#define INCLUDED_AIS_SLIDING_MAX_H
+
+#include <stdint.h>
+#include <vector>
+
+namespace gr {
+  namespace ais {
+
+    /*!
+     * Maximum over the last \p len values pushed, in constant amortized
+     * time per value: a monotonic queue of the values that could still
+     * become the maximum, in a ring of \p len slots.
+     */
+    class sliding_max
+    {
+    public:
+      sliding_max(int len)
+        : d_len(len), d_val(len), d_idx(len),
+          d_head(0), d_count(0), d_n(0)
+      {}
+
+      //! Add \p x and return the maximum of the last len values added
+      float push(float x)
+      {
+        // Expire the oldest entry before adding, so the ring never
+        // holds more than len entries
+        if(d_count > 0 && d_idx[d_head] + d_len <= d_n) {
+          d_head = (d_head + 1) % d_len;
+          d_count--;
+        }
+        // Nothing older and no bigger than x can be the maximum again
+        while(d_count > 0) {
+          int back = (d_head + d_count - 1) % d_len;
+          if(d_val[back] > x)
+            break;
+          d_count--;
+        }
+        int back = (d_head + d_count) % d_len;
+        d_val[back] = x;
+        d_idx[back] = d_n++;
+        d_count++;
+        return d_val[d_head];
+      }
+
+    private:
+      int d_len;
+      std::vector<float> d_val;
+      std::vector<uint64_t> d_idx;
+      int d_head, d_count;
+      uint64_t d_n;
+    };
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_AIS_SLIDING_MAX_H */
@@ -0,0 +1,93 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+#include "soft_slicer_fb_impl.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace gr {
+  namespace ais {
+
+    soft_slicer_fb::sptr
+    soft_slicer_fb::make(float alpha)
+    {
+      return gnuradio::get_initial_sptr
+        (new soft_slicer_fb_impl(alpha));
+    }
+
+    soft_slicer_fb_impl::soft_slicer_fb_impl(float alpha)
+      : gr::sync_block("soft_slicer_fb",
+                       gr::io_signature::make(1, 1, sizeof(float)),
+                       gr::io_signature::make(1, 2, sizeof(char))),
+        d_alpha(alpha),
+        d_mean(0),
+        d_sq(0)
+    {
+      if(alpha <= 0 || alpha > 1)
+        throw std::out_of_range("alpha must be in (0, 1]");
+    }
+
+    soft_slicer_fb_impl::~soft_slicer_fb_impl()
+    {
+    }
+
+    float
+    soft_slicer_fb_impl::noise_variance() const
+    {
+      // Keep some variance so a clean signal saturates rather than
+      // dividing by zero
+      return std::max(d_sq - d_mean*d_mean, 1e-3f*d_sq + 1e-12f);
+    }
+
+    int
+    soft_slicer_fb_impl::work(int noutput_items,
+                              gr_vector_const_void_star &input_items,
+                              gr_vector_void_star &output_items)
+    {
+      const float *in = (const float *) input_items[0];
+      uint8_t *out = (uint8_t *) output_items[0];
+
+      if(output_items.size() < 2) {
+        for(int i = 0; i < noutput_items; i++)
+          out[i] = in[i] >= 0;
+        return noutput_items;
+      }
+
+      // For +/-A in noise of variance v, the LLR of x is 2*A*x/v
+      uint8_t *conf = (uint8_t *) output_items[1];
+      for(int i = 0; i < noutput_items; i++) {
+        const float x = in[i], a = fabsf(x);
+        out[i] = x >= 0;
+        d_mean += d_alpha*(a - d_mean);
+        d_sq += d_alpha*(x*x - d_sq);
+        float llr = 2*d_mean*a/noise_variance();
+        conf[i] = (uint8_t) std::min(255.0f, 4*llr + 0.5f);
+      }
+      return noutput_items;
+    }
+
+  } /* namespace ais */
+} /* namespace gr */
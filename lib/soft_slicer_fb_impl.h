@@ -0,0 +1,51 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIS_SOFT_SLICER_FB_IMPL_H
+#define INCLUDED_AIS_SOFT_SLICER_FB_IMPL_H
+
+#include <ais/soft_slicer_fb.h>
+
+namespace gr {
+  namespace ais {
+
+    class soft_slicer_fb_impl : public soft_slicer_fb
+    {
+     private:
+      float d_alpha;
+      float d_mean;            // of |x|
+      float d_sq;              // of x^2
+
+     public:
+      soft_slicer_fb_impl(float alpha);
+      ~soft_slicer_fb_impl();
+
+      float amplitude() const { return d_mean; }
+      float noise_variance() const;
+
+      int work(int noutput_items,
+               gr_vector_const_void_star &input_items,
+               gr_vector_void_star &output_items);
+    };
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_AIS_SOFT_SLICER_FB_IMPL_H */
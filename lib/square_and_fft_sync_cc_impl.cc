@@ -0,0 +1,120 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+#include <gnuradio/expj.h>
+#include "square_and_fft_sync_cc_impl.h"
+#include "freqest_impl.h"
+#include <volk/volk.h>
+
+namespace gr {
+  namespace ais {
+
+    square_and_fft_sync_cc::sptr
+    square_and_fft_sync_cc::make(float sample_rate, int data_rate, int fftlen,
+                                 bool interpolate)
+    {
+      return gnuradio::get_initial_sptr
+        (new square_and_fft_sync_cc_impl(sample_rate, data_rate, fftlen,
+                                         interpolate));
+    }
+
+    /*
+     * The private constructor
+     */
+    square_and_fft_sync_cc_impl::square_and_fft_sync_cc_impl(float sample_rate, int data_rate, int fftlen,
+                                                             bool interpolate)
+      : gr::sync_block("square_and_fft_sync_cc",
+              gr::io_signature::make(1, 1, sizeof(gr_complex)),
+              gr::io_signature::make(1, 1, sizeof(gr_complex))),
+        d_fftlen(fftlen),
+        d_interpolate(interpolate),
+        d_freq(0),
+        d_phase(1, 0)
+    {
+        //the hier block handed freqest a truncated sample rate; do the
+        //same so the estimates come out identical.
+        float est_rate = float(int(sample_rate));
+        d_offset = fftlen * (float(data_rate) / est_rate);
+        d_binsize = est_rate / float(fftlen);
+        d_sensitivity = -2.0 * M_PI / sample_rate;
+
+        d_fft = new fft::fft_complex(fftlen, true);
+        d_spectrum = (gr_complex *)
+                     volk_malloc(sizeof(gr_complex)*fftlen, volk_get_alignment());
+        d_mag = (float *) volk_malloc(sizeof(float)*fftlen, volk_get_alignment());
+        d_sum = (float *) volk_malloc(sizeof(float)*fftlen, volk_get_alignment());
+
+        //each estimate is made from, and applied to, one FFT's worth of input
+        set_output_multiple(fftlen);
+    }
+
+    /*
+     * Our virtual destructor.
+     */
+    square_and_fft_sync_cc_impl::~square_and_fft_sync_cc_impl()
+    {
+        delete d_fft;
+        volk_free(d_spectrum);
+        volk_free(d_mag);
+        volk_free(d_sum);
+    }
+
+    int
+    square_and_fft_sync_cc_impl::work(int noutput_items,
+                                      gr_vector_const_void_star &input_items,
+                                      gr_vector_void_star &output_items)
+    {
+        const gr_complex *in = (const gr_complex *) input_items[0];
+        gr_complex *out = (gr_complex *) output_items[0];
+
+        gr_complex *fftbuf = d_fft->get_inbuf();
+        const int half = d_fftlen - d_fftlen/2; //ceil(fftlen/2), as fft_vcc does
+
+        for(int i = 0; i < noutput_items; i += d_fftlen) {
+            //square straight into the FFT input
+            volk_32fc_x2_multiply_32fc(fftbuf, &in[i], &in[i], d_fftlen);
+            d_fft->execute();
+
+            //fftshift so DC is in the middle
+            const gr_complex *fftout = d_fft->get_outbuf();
+            memcpy(&d_spectrum[0], &fftout[half], sizeof(gr_complex)*(d_fftlen-half));
+            memcpy(&d_spectrum[d_fftlen-half], &fftout[0], sizeof(gr_complex)*half);
+
+            d_freq = freqest_impl::estimate(d_spectrum, d_mag, d_sum, d_fftlen,
+                                            d_offset, d_binsize, d_interpolate);
+
+            //derotate this block by the new estimate
+            gr_complex phase_inc = gr_expj(d_sensitivity * d_freq);
+            volk_32fc_s32fc_x2_rotator_32fc(&out[i], &in[i], phase_inc,
+                                            &d_phase, d_fftlen);
+        }
+        d_phase /= std::abs(d_phase); //keep the NCO from drifting in amplitude
+
+        return noutput_items;
+    }
+
+  } /* namespace ais */
+} /* namespace gr */
+
@@ -0,0 +1,61 @@
+/* -*- c++ -*- */
+/* 
+ * Copyright 2026 Nick Foster
+ * 
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ * 
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_AIS_SQUARE_AND_FFT_SYNC_CC_IMPL_H
+#define INCLUDED_AIS_SQUARE_AND_FFT_SYNC_CC_IMPL_H
+
+#include <ais/square_and_fft_sync_cc.h>
+#include <gnuradio/fft/fft.h>
+
+namespace gr {
+  namespace ais {
+
+    class square_and_fft_sync_cc_impl : public square_and_fft_sync_cc
+    {
+     private:
+      int d_fftlen;
+      int d_offset;
+      float d_binsize;
+      float d_sensitivity;
+      bool d_interpolate;
+      float d_freq;
+      gr_complex d_phase;
+      fft::fft_complex *d_fft;
+      gr_complex *d_spectrum;
+      float *d_mag;
+      float *d_sum;
+
+     public:
+      square_and_fft_sync_cc_impl(float sample_rate, int data_rate, int fftlen,
+                                  bool interpolate);
+      ~square_and_fft_sync_cc_impl();
+
+      float freq() const { return d_freq; }
+
+      int work(int noutput_items,
+               gr_vector_const_void_star &input_items,
+               gr_vector_void_star &output_items);
+    };
+
+  } // namespace ais
+} // namespace gr
+
+#endif /* INCLUDED_AIS_SQUARE_AND_FFT_SYNC_CC_IMPL_H */
+
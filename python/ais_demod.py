@@ -18,39 +18,168 @@ from gnuradio import analog
 import math
 import ais
 import random
+
+#digital.gmsk_mod without its unpacker: takes one bit (0 or 1) per symbol, not bytes
+class gmsk_bits_mod(gr.hier_block2):
+    def __init__(self, samples_per_symbol, bt):
+        gr.hier_block2.__init__(self, "gmsk_bits_mod",
+                                gr.io_signature(1, 1, gr.sizeof_char),
+                                gr.io_signature(1, 1, gr.sizeof_gr_complex))
+        #a Gaussian convolved with a rectangle a symbol long, as gmsk_mod
+        gaussian = filter.firdes.gaussian(1, samples_per_symbol, bt, 4*samples_per_symbol)
+        taps = [0.0]*(len(gaussian) + samples_per_symbol - 1)
+        for i in range(len(gaussian)):
+            for j in range(samples_per_symbol):
+                taps[i+j] += gaussian[i]
+        self.nrz = digital.chunks_to_symbols_bf([-1, 1])
+        self.shape = filter.interp_fir_filter_fff(samples_per_symbol, taps)
+        self.fm = analog.frequency_modulator_fc((math.pi/2)/samples_per_symbol)
+        self.connect(self, self.nrz, self.shape, self.fm, self)
+
 class ais_demod(gr.hier_block2):
     def __init__(self, options):
+        #soft mode outputs the raw channel bits, still NRZI coded, and a confidence for each
+        #(see soft_slicer_fb), for hdlc_deframer_bp to decode and repair
+        self._soft = options.get("soft", False)
+        if self._soft:
+            outsig = gr.io_signature(2, 2, gr.sizeof_char)
+        else:
+            outsig = gr.io_signature(1, 1, gr.sizeof_char)
+        #"discriminator": slice the phase change across each symbol
+        #"viterbi": sequence detection over the GMSK trellis (gmsk_viterbi_cb), a few dB better in noise
+        self._detector = options.get("detector", "discriminator")
+        if self._detector not in ("discriminator", "viterbi"):
+            raise ValueError("detector must be 'discriminator' or 'viterbi'")
+        if self._detector == "viterbi" and self._soft:
+            raise ValueError("the Viterbi detector has no soft output")
 
         gr.hier_block2.__init__(self, "ais_demod",
                                 gr.io_signature(1, 1, gr.sizeof_gr_complex), # Input signature
-                                gr.io_signature(1, 1, gr.sizeof_char)) # Output signature
+                                outsig) # Output signature
 
         self._samples_per_symbol = options[ "samples_per_symbol" ]
         self._bits_per_sec = options[ "bits_per_sec" ]
         self._samplerate = self._samples_per_symbol * self._bits_per_sec
         self._clockrec_gain = options[ "clockrec_gain" ]
         self._omega_relative_limit = options[ "omega_relative_limit" ]
+        #optional high loop gain for the first few symbols after each preamble, to pull in at low sps
+        self._acq_gain = options.get("acq_gain", 0)
+        self._acq_len = options.get("acq_len", 0)
+        #AGC window of about 100 symbols whatever the rate
+        self._agc_len = int(round(512 * self._samples_per_symbol / 5.0))
         self.fftlen = options[ "fftlen" ]
-        self.freq_sync = ais.square_and_fft_sync_cc(self._samplerate, self._bits_per_sec, self.fftlen)
-        self.agc = analog.feedforward_agc_cc(512, 2)
-        self.preamble = [1,1,0,0]*7
-        self.mod = digital.gmsk_mod(self._samples_per_symbol, 0.4)
+        self.fft_interpolate = options.get("fft_interpolate", False)
+        #"fft": continuous square-and-FFT loop ahead of everything
+        #"preamble": per-burst estimate from the correlator, applied only over each burst
+        self._freq_sync = options.get("freq_sync", "fft")
+        #search carrier offsets up to +/- this many Hz with a bank of correlators (satellite/airborne)
+        self._doppler_max = options.get("doppler_max", 0)
+        if self._doppler_max > 0:
+            self._freq_sync = "preamble"
+        if self._freq_sync == "fft":
+            self.freq_sync = ais.square_and_fft_sync_cc(self._samplerate, int(self._bits_per_sec), self.fftlen, self.fft_interpolate)
+        elif self._freq_sync != "preamble":
+            raise ValueError("freq_sync must be 'fft' or 'preamble'")
+        self._burst_len = int(math.ceil(1280 * self._samples_per_symbol)) #longest AIS transmission, 5 slots
+        #scale each burst from its correlation peak instead of running an AGC over every sample
+        self._burst_agc = options.get("burst_agc", False)
+        #the preamble template: the 24-bit training sequence 0101... and the start flag,
+        #NRZI coded (a zero is a change), one channel bit per symbol
+        self.preamble = []
+        level = 1
+        for bit in [0,1]*12 + [0,1,1,1,1,1,1,0]:
+            if not bit:
+                level = 1 - level
+            self.preamble.append(level)
+        self.mod = gmsk_bits_mod(int(round(self._samples_per_symbol)), 0.4)
         self.mod_vector = digital.modulate_vector_bc(self.mod.to_basic_block(), self.preamble, [1])
-        self.preamble_detect = ais.corr_est_cc(self.mod_vector,
-                                               self._samples_per_symbol,
-                                               1, #mark delay
-                                               0.9) #threshold
+
+        #demod_cb is opt-in until its bits are shown to match the separate blocks' on a real GNU Radio install.
+        #It has no Doppler bank, burst AGC, soft output or Viterbi detector, so any of them takes the separate blocks
+        if options.get("fused_demod", False) and self._doppler_max == 0 and not self._burst_agc and not self._soft \
+           and self._detector == "discriminator":
+            #AGC, preamble detection, clock recovery, discriminator, slicer and NRZI decoding all in one block
+            self.demod = ais.demod_cb(self.mod_vector,
+                                      self._samples_per_symbol,
+                                      1, #mark delay
+                                      0.9, #threshold
+                                      self._clockrec_gain,
+                                      self._omega_relative_limit,
+                                      self._agc_len, 2, #AGC window, reference
+                                      ais.CORR_ENGINE_AUTO,
+                                      options.get("corr_max_latency", 0))
+            if self._acq_len > 0:
+                self.demod.set_acquisition(self._acq_gain, self._acq_len)
+            if self._freq_sync == "fft":
+                self.connect(self, self.freq_sync, self.demod, self)
+            else:
+                self.demod.set_freq_correction(True)
+                self.connect(self, self.demod, self)
+            return
+
+        #the same thing as a chain of separate blocks, for reference
+        if self._burst_agc:
+            #loses more frames than the sliding AGC on equal-level bursts (apps/ais_bench_demod --burst-agc)
+            #nothing normalizes the input, so the threshold has to be relative to the noise
+            self.preamble_detect = ais.corr_est_cc(self.mod_vector,
+                                                   self._samples_per_symbol,
+                                                   1, #mark delay
+                                                   1e-6, #per-sample false alarm probability
+                                                   ais.THRESHOLD_CFAR,
+                                                   ais.CORR_ENGINE_AUTO,
+                                                   options.get("corr_max_latency", 0))
+            self.preamble_detect.set_burst_agc(2, self._burst_len)
+        else:
+            self.agc = analog.feedforward_agc_cc(self._agc_len, 2)
+            self.preamble_detect = ais.corr_est_cc(self.mod_vector,
+                                                   self._samples_per_symbol,
+                                                   1, #mark delay
+                                                   0.9, #threshold
+                                                   ais.THRESHOLD_ABSOLUTE,
+                                                   ais.CORR_ENGINE_AUTO,
+                                                   options.get("corr_max_latency", 0)) #in samples; 0 for no limit
+        if self._doppler_max > 0:
+            self.preamble_detect.set_doppler_bank(2*math.pi*self._doppler_max/self._samplerate)
         self.clockrec = ais.msk_timing_recovery_cc(self._samples_per_symbol,
                                                        self._clockrec_gain, #gain
                                                        self._omega_relative_limit, #error lim
                                                        1) #output sps
+        if self._acq_len > 0:
+            self.clockrec.set_acquisition(self._acq_gain, self._acq_len)
 
         sensitivity = (math.pi / 2)
         self.demod = analog.quadrature_demod_cf(sensitivity) #param is gain
-        self.slicer = digital.binary_slicer_fb()
-        self.diff = digital.diff_decoder_bb(2)
-        self.invert = ais.invert() #NRZI signal diff decoded and inverted should give original signal
+        if self._detector == "viterbi":
+            #resets on each burst's corr_est tags and NRZI decodes itself
+            self.viterbi = ais.gmsk_viterbi_cb()
+        elif self._soft:
+            self.slicer = ais.soft_slicer_fb()
+        else:
+            self.slicer = digital.binary_slicer_fb()
+            self.diff = digital.diff_decoder_bb(2)
+            self.invert = ais.invert() #NRZI signal diff decoded and inverted should give original signal
 
 #        self.connect(self, self.gmsk_sync)
 
-        self.connect(self, self.freq_sync, self.agc, (self.preamble_detect, 0), self.clockrec, self.demod, self.slicer, self.diff, self.invert, self)
+        chain = [self]
+        if self._freq_sync == "fft":
+            chain.append(self.freq_sync)
+        if not self._burst_agc:
+            chain.append(self.agc)
+        chain.append((self.preamble_detect, 0))
+        if self._freq_sync == "preamble":
+            #the derotator reads the freq_est tags, which are off by default
+            self.preamble_detect.set_freq_estimate(True)
+            self.derotate = ais.burst_derotator_cc(self._burst_len)
+            chain.append(self.derotate)
+        chain.append(self.clockrec)
+        if self._detector == "viterbi":
+            self.connect(*(chain + [self.viterbi, self]))
+            return
+        chain += [self.demod, self.slicer]
+        if self._soft:
+            self.connect(*chain)
+            self.connect(self.slicer, self)
+            self.connect((self.slicer, 1), (self, 1))
+        else:
+            self.connect(*(chain + [self.diff, self.invert, self]))
@@ -12,17 +12,19 @@ import ais
 
 
 class square_and_fft_sync_cc(gr.hier_block2):
-    def __init__(self, samplerate, bits_per_sec, fftlen):
+    def __init__(self, samplerate, bits_per_sec, fftlen, interpolate=False):
         gr.hier_block2.__init__(self, "square_and_fft_sync_cc",
                                 gr.io_signature(1, 1, gr.sizeof_gr_complex), # Input signature
                                 gr.io_signature(1, 1, gr.sizeof_gr_complex)) # Output signature
 
         #this is just the old square-and-fft method
+        #kept as a reference for ais.square_and_fft_sync_cc, which does the
+        #same thing in one block
         #ais.freqest is simply looking for peaks spaced bits-per-sec apart
         self.square = blocks.multiply_cc(1)
         self.fftvect = blocks.stream_to_vector(gr.sizeof_gr_complex, fftlen)
         self.fft = fft.fft_vcc(fftlen, True, window.rectangular(fftlen), True)
-        self.freqest = ais.freqest(int(samplerate), int(bits_per_sec), fftlen)
+        self.freqest = ais.freqest(int(samplerate), int(bits_per_sec), fftlen, interpolate)
         self.repeat = blocks.repeat(gr.sizeof_float, fftlen)
         self.fm = analog.frequency_modulator_fc(-1.0/(float(samplerate)/(2*pi)))
         self.mix = blocks.multiply_cc(1)
@@ -38,38 +38,74 @@ import ais
 #hier block encapsulating all the signal processing after the source
 #could probably be split into its own file
 class ais_rx(gr.hier_block2):
-    def __init__(self, freq, rate, designator):
+    def __init__(self, freq, rate, designator, channelized=False, sps=5, freq_sync="fft", doppler=0, squelch=0, burst_agc=False, flip_bits=0, detector="discriminator"):
         gr.hier_block2.__init__(self,
                                 "ais_rx",
                                 gr.io_signature(1,1,gr.sizeof_gr_complex),
                                 gr.io_signature(0,0,0))
 
         self._bits_per_sec = 9600.0
-        self._samples_per_symbol = 5
-        self.coeffs = filter.firdes.low_pass(1, rate, 11000, 1000)
-        self._filter_decimation = int(rate/(self._bits_per_sec*self._samples_per_symbol))
-        self.filter = filter.freq_xlating_fir_filter_ccf(self._filter_decimation,
-                                                     self.coeffs,
-                                                     freq,
-                                                     rate)
+        self._samples_per_symbol = sps
+        if channelized:
+            #input is already one channel at exactly samples_per_symbol
+            self.filter = None
+            self._filter_decimation = 1
+            rate = self._bits_per_sec*self._samples_per_symbol
+        else:
+            self._filter_decimation = int(rate/(self._bits_per_sec*self._samples_per_symbol))
+            #keep the passband inside the output Nyquist at low sps
+            cutoff = min(11000, 0.42*rate/self._filter_decimation)
+            self.coeffs = filter.firdes.low_pass(1, rate, cutoff, 1000)
+            self.filter = filter.freq_xlating_fir_filter_ccf(self._filter_decimation,
+                                                         self.coeffs,
+                                                         freq,
+                                                         rate)
 #        self.resamp = pfb.arb_resampler_ccf((self._bits_per_sec*self._samples_per_symbol)/int(rate/self._filter_decimation))
         options = {}
         options[ "samples_per_symbol" ] = (rate/self._filter_decimation)/self._bits_per_sec
         options[ "clockrec_gain" ] = 0.04
         options[ "omega_relative_limit" ] = 0.01
+        #no acquisition gear (acq_gain/acq_len): a high gain after each preamble lost more
+        #frames than it saved at 2 and 5 sps alike; see apps/ais_bench_demod
         options[ "bits_per_sec" ] = self._bits_per_sec
+        options[ "freq_sync" ] = freq_sync
+        options[ "doppler_max" ] = doppler
+        options[ "burst_agc" ] = burst_agc
+        options[ "soft" ] = flip_bits > 0
+        options[ "detector" ] = detector
         options[ "fftlen" ] = 1024 #trades off accuracy of freq estimation in presence of noise, vs. delay time.
+        options[ "fft_interpolate" ] = False #sub-bin peak refinement, for shorter FFTs; not yet validated against the plain peak
         options[ "samp_rate" ] = self._bits_per_sec * self._samples_per_symbol
         self.demod = ais.ais_demod(options) #ais_demod takes in complex baseband and spits out 1-bit unpacked bitstream
-        self.deframer = digital.hdlc_deframer_bp(11,64) #takes bytes, deframes, unstuffs, CRCs, and emits PDUs with frame contents
+        self.pack = blocks.unpacked_to_packed_bb(1, gr.GR_MSB_FIRST) #eight bits to a byte for the deframer
+        #takes packed bits, deframes, unstuffs, CRCs, and emits PDUs with frame contents. with
+        #flip_bits, also NRZI decodes, and repairs failed frames from the bit confidences
+        self.deframer = ais.hdlc_deframer_bp(11, 64, flip_bits > 0, flip_bits)
         self.nmea = ais.pdu_to_nmea(designator) #turns data PDUs into NMEA sentences
 #        self.msgq = ais.pdu_to_msgq(queue) #posts PDUs to message queue for main program to parse at will
 #        self.parse = ais.parse(queue, designator) #ais_parse.cc, calculates CRC, parses data into NMEA AIVDM message, moves data onto queue
 
-        self.connect(self,
-                     self.filter,
-                     self.demod,
+        #optionally drop the empty spectrum between bursts before any of the demod runs:
+        #8-symbol power blocks, 32 symbols of preroll for the ramp and preamble, and a
+        #hangover covering an FFT frame of the frequency sync plus the correlator's look-ahead
+        #(the deframer's "offset" then counts post-squelch samples; see the block's "gap" tags)
+        if squelch > 0:
+            isps = int(round(options[ "samples_per_symbol" ]))
+            self.squelch = ais.energy_squelch_cc(8*isps, squelch, 32*isps, options[ "fftlen" ] + 100*isps)
+            head = self.squelch
+            self.connect(self.squelch, self.demod)
+        else:
+            head = self.demod
+        if self.filter is not None:
+            self.connect(self, self.filter, head)
+        else:
+            self.connect(self, head)
+        self.connect(self.demod,
+                     self.pack,
                      self.deframer)
+        if flip_bits > 0:
+            self.conf = blocks.stream_to_vector(1, 8) #a confidence per bit, eight to a packed byte
+            self.connect((self.demod, 1), self.conf, (self.deframer, 1))
         self.msg_connect(self.deframer, "out", self.nmea, "print")
 
 class ais_radio (gr.top_block, pubsub):
@@ -78,17 +114,51 @@ class ais_radio (gr.top_block, pubsub):
     pubsub.__init__(self)
     self._options = options
 
+    if not 0 <= options.flip_bits <= 8:
+        raise ValueError("--flip-bits must be between 0 and 8")
+
     self._u = self._setup_source(options)
     self._rate = self.get_rate()
     print("Rate is %i" % (self._rate,))
 
     if options.singlechannel is True:
-        self._rx_paths = (ais_rx(0, options.rate, "A"),)
+        channels = (("A", 0),)
     else:
-        self._rx_paths = (ais_rx(161.975e6 - 162.0e6, options.rate, "A"),
-                          ais_rx(162.025e6 - 162.0e6, options.rate, "B"))
-    for rx_path in self._rx_paths:
-        self.connect(self._u, rx_path)
+        channels = (("A", 161.975e6 - 162.0e6),
+                    ("B", 162.025e6 - 162.0e6))
+        if options.asm:
+            channels += (("2027", 161.950e6 - 162.0e6),
+                         ("2028", 162.000e6 - 162.0e6))
+        if options.longrange:
+            channels += (("75", 156.775e6 - 162.0e6),
+                         ("76", 156.825e6 - 162.0e6))
+        channels = tuple(c for c in channels if abs(c[1]) < options.rate/2 - 12.5e3)
+
+    #short of --doppler, the carrier offset comes out in the square-and-FFT loop. ais_rx
+    #can correct each burst from its preamble instead, but past about 150 Hz of offset,
+    #well inside AIS tolerances, that loses far more frames (apps/ais_bench_demod --freq-sync)
+
+    #each burst could also be scaled from its preamble correlation (ais_rx's burst_agc)
+    #in place of the sliding AGC, but that loses more frames at every Eb/N0 and sps
+    #tried (apps/ais_bench_demod --burst-agc), so the sliding AGC always runs
+
+    #samples per symbol to demodulate at. ais_rx runs at 2 as well, but loses several
+    #times the frames 5 does (apps/ais_bench_demod), so it isn't offered here
+    sps = 5
+    if options.rate % 25e3 == 0:
+        #one polyphase channelizer pulls every channel out at exactly sps
+        self._channelizer = ais.channelizer_ccf(options.rate,
+                                                [float(c[1]) for c in channels],
+                                                9600.0*sps)
+        self.connect(self._u, self._channelizer)
+        self._rx_paths = tuple(ais_rx(c[1], options.rate, c[0], True, sps, "fft", options.doppler, options.squelch, False, options.flip_bits, options.detector) for c in channels)
+        for i, rx_path in enumerate(self._rx_paths):
+            self.connect((self._channelizer, i), rx_path)
+    else:
+        #rate isn't on the 25kHz channel grid; filter each channel separately
+        self._rx_paths = tuple(ais_rx(c[1], options.rate, c[0], False, sps, "fft", options.doppler, options.squelch, False, options.flip_bits, options.detector) for c in channels)
+        for rx_path in self._rx_paths:
+            self.connect(self._u, rx_path)
 
     #now subscribe to set various options via pubsub
     self.subscribe("gain", self.set_gain)
@@ -121,6 +191,18 @@ class ais_radio (gr.top_block, pubsub):
                       help="set sample rate [default=%default]")
     group.add_option("-S", "--singlechannel", action="store_true", default=False,
                      help="Use only a single channel instead of looking at both A & B [default=%default]")
+    group.add_option("--asm", action="store_true", default=False,
+                     help="Also receive ASM channels 2027 and 2028 [default=%default]")
+    group.add_option("--doppler", type="eng_float", default=0,
+                     help="Search carrier offsets up to +/- this many Hz per burst, for satellite or airborne reception; corrects each burst from its preamble instead of the square-and-FFT loop [default=%default]")
+    group.add_option("--squelch", type="eng_float", default=0,
+                     help="Only demodulate where the channel power is this many dB above its noise floor; 0 to demodulate everything [default=%default]")
+    group.add_option("--flip-bits", type="int", default=0,
+                     help="Repair frames failing the CRC by trying flips of their doubtful bits, if there are no more than this many, 0 to 8; each adds to the chance of a bad frame passing [default=%default]")
+    group.add_option("--detector", type="choice", choices=("discriminator", "viterbi"), default="discriminator",
+                     help="Bit detector: slice the phase change per symbol, or Viterbi over the GMSK trellis (fewer lost frames at 14-17 dB Eb/N0, see apps/ais_bench_demod --detector; no soft output so not with --flip-bits) [default=%default]")
+    group.add_option("--longrange", action="store_true", default=False,
+                     help="Also receive long-range channels 75 and 76 (needs a wide enough rate) [default=%default]")
 
     parser.add_option_group(group)
 
@@ -209,7 +291,10 @@ class ais_radio (gr.top_block, pubsub):
         src = blocks.udp_source(gr.sizeof_gr_complex, ip, int(port))
         print("Using UDP source %s:%s" % (ip, port))
       else:
-        src = blocks.file_source(gr.sizeof_gr_complex, options.source)
+        #cf32, cs8, cu8, cs16 or SigMF, picked by file name
+        src = ais.iq_file_source(options.source)
+        if src.sample_rate() > 0:
+          self._rate = options.rate = src.sample_rate()
         print("Using file source %s" % options.source)
 
     return src
@@ -10,6 +10,15 @@
 #include "ais/pdu_to_nmea.h"
 #include "ais/msk_timing_recovery_cc.h"
 #include "ais/corr_est_cc.h"
+#include "ais/square_and_fft_sync_cc.h"
+#include "ais/burst_derotator_cc.h"
+#include "ais/energy_squelch_cc.h"
+#include "ais/soft_slicer_fb.h"
+#include "ais/gmsk_viterbi_cb.h"
+#include "ais/demod_cb.h"
+#include "ais/iq_file_source.h"
+#include "ais/hdlc_deframer_bp.h"
+#include "ais/channelizer_ccf.h"
 %}
 
 
@@ -18,9 +27,29 @@ GR_SWIG_BLOCK_MAGIC2(ais, freqest);
 %include "ais/invert.h"
 GR_SWIG_BLOCK_MAGIC2(ais, invert);
 %include "ais/msk_timing_recovery_cc.h"
-GR_SWIG_BLOCK_MAGIC2(ais, msk_timing_recovery_cc);
+GR_SWIG_BLOCK_MAGIC2_TMPL(ais, msk_timing_recovery_cc, msk_timing_recovery<gr_complex>);
+GR_SWIG_BLOCK_MAGIC2_TMPL(ais, msk_timing_recovery_sc16, msk_timing_recovery<lv_16sc_t>);
 %include "ais/corr_est_cc.h"
-GR_SWIG_BLOCK_MAGIC2(ais, corr_est_cc);
+GR_SWIG_BLOCK_MAGIC2_TMPL(ais, corr_est_cc, corr_est<gr_complex>);
+GR_SWIG_BLOCK_MAGIC2_TMPL(ais, corr_est_sc16, corr_est<lv_16sc_t>);
+%include "ais/square_and_fft_sync_cc.h"
+GR_SWIG_BLOCK_MAGIC2(ais, square_and_fft_sync_cc);
+%include "ais/burst_derotator_cc.h"
+GR_SWIG_BLOCK_MAGIC2(ais, burst_derotator_cc);
+%include "ais/energy_squelch_cc.h"
+GR_SWIG_BLOCK_MAGIC2(ais, energy_squelch_cc);
+%include "ais/soft_slicer_fb.h"
+GR_SWIG_BLOCK_MAGIC2(ais, soft_slicer_fb);
+%include "ais/gmsk_viterbi_cb.h"
+GR_SWIG_BLOCK_MAGIC2(ais, gmsk_viterbi_cb);
+%include "ais/demod_cb.h"
+GR_SWIG_BLOCK_MAGIC2(ais, demod_cb);
+%include "ais/iq_file_source.h"
+GR_SWIG_BLOCK_MAGIC2(ais, iq_file_source);
+%include "ais/hdlc_deframer_bp.h"
+GR_SWIG_BLOCK_MAGIC2(ais, hdlc_deframer_bp);
+%include "ais/channelizer_ccf.h"
+GR_SWIG_BLOCK_MAGIC2(ais, channelizer_ccf);
 
 %include "ais/pdu_to_nmea.h"
 GR_SWIG_BLOCK_MAGIC2(ais, pdu_to_nmea);